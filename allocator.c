@@ -0,0 +1,130 @@
+// --- FILE: allocator.c ---
+#include "allocator.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Round up to arena alignment
+static size_t alignUp(size_t n) {
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+#define CHUNK_HEADER alignUp(sizeof(ArenaChunk))
+
+static void trackUse(AllocStats* s, size_t bytes) {
+    s->allocations++;
+    s->bytesInUse += bytes;
+    if (s->bytesInUse > s->peakBytesInUse)
+        s->peakBytesInUse = s->bytesInUse;
+}
+
+// --- Arena ---
+void arenaInit(Arena* a, size_t chunkSize) {
+    a->head = NULL;
+    a->chunkSize = chunkSize ? chunkSize : ARENA_DEFAULT_CHUNK;
+    a->stats = (AllocStats){0};
+}
+
+void* arenaAlloc(Arena* a, size_t size) {
+    size = alignUp(size ? size : 1);
+
+    ArenaChunk* chunk = a->head;
+    if (!chunk || chunk->size - chunk->used < size) {
+        size_t capacity = (size > a->chunkSize) ? size : a->chunkSize;
+        chunk = (ArenaChunk*)malloc(CHUNK_HEADER + capacity);
+        if (!chunk) {
+            fprintf(stderr, "Arena memory failed\n");
+            exit(1);
+        }
+        chunk->size = capacity;
+        chunk->used = 0;
+        chunk->next = a->head;
+        a->head = chunk;
+        a->stats.chunks++;
+        a->stats.bytesReserved += CHUNK_HEADER + capacity;
+    }
+
+    void* ptr = (unsigned char*)chunk + CHUNK_HEADER + chunk->used;
+    chunk->used += size;
+    trackUse(&a->stats, size);
+    return ptr;
+}
+
+// Keep the newest chunk for reuse, release the rest
+void arenaReset(Arena* a) {
+    if (!a->head) return;
+    ArenaChunk* cur = a->head->next;
+    while (cur) {
+        ArenaChunk* tmp = cur;
+        cur = cur->next;
+        a->stats.bytesReserved -= CHUNK_HEADER + tmp->size;
+        a->stats.chunks--;
+        free(tmp);
+    }
+    a->head->next = NULL;
+    a->head->used = 0;
+    a->stats.frees += a->stats.allocations - a->stats.frees;
+    a->stats.bytesInUse = 0;
+}
+
+void arenaDestroy(Arena* a) {
+    ArenaChunk* cur = a->head;
+    while (cur) {
+        ArenaChunk* tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+    a->head = NULL;
+    a->stats.bytesReserved = 0;
+    a->stats.bytesInUse = 0;
+    a->stats.chunks = 0;
+}
+
+// --- Pool ---
+void poolInit(Pool* p, size_t blockSize, size_t blocksPerChunk) {
+    if (blockSize < sizeof(void*)) blockSize = sizeof(void*);
+    p->blockSize = alignUp(blockSize);
+    p->freeList = NULL;
+    p->stats = (AllocStats){0};
+    arenaInit(&p->arena, p->blockSize * (blocksPerChunk ? blocksPerChunk : 64));
+}
+
+void* poolAlloc(Pool* p) {
+    void* block;
+    if (p->freeList) {
+        block = p->freeList;
+        p->freeList = *(void**)block;
+    } else {
+        block = arenaAlloc(&p->arena, p->blockSize);
+        p->stats.bytesReserved = p->arena.stats.bytesReserved;
+        p->stats.chunks = p->arena.stats.chunks;
+    }
+    trackUse(&p->stats, p->blockSize);
+    return block;
+}
+
+void poolFree(Pool* p, void* block) {
+    if (!block) return;
+    *(void**)block = p->freeList;
+    p->freeList = block;
+    p->stats.frees++;
+    p->stats.bytesInUse -= p->blockSize;
+}
+
+// O(chunks) teardown: blocks are never freed one by one
+void poolDestroy(Pool* p) {
+    arenaDestroy(&p->arena);
+    p->freeList = NULL;
+    p->stats.bytesReserved = 0;
+    p->stats.bytesInUse = 0;
+    p->stats.chunks = 0;
+}
+
+// Print statistics
+void printAllocStats(const char* label, const AllocStats* s) {
+    printf("%-14s | Reserved: %7lu B | In use: %7lu B | Peak: %7lu B\n",
+           label, (unsigned long)s->bytesReserved,
+           (unsigned long)s->bytesInUse, (unsigned long)s->peakBytesInUse);
+    printf("%-14s | Allocs: %lu | Frees: %lu | Chunks: %lu\n", "",
+           (unsigned long)s->allocations, (unsigned long)s->frees,
+           (unsigned long)s->chunks);
+}
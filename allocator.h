@@ -0,0 +1,57 @@
+// --- FILE: allocator.h ---
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGN 16
+#define ARENA_DEFAULT_CHUNK 4096
+
+// Allocation statistics
+typedef struct AllocStats {
+    size_t bytesReserved;   // Obtained from malloc
+    size_t bytesInUse;      // Handed out and not yet returned
+    size_t peakBytesInUse;
+    size_t allocations;
+    size_t frees;
+    size_t chunks;
+} AllocStats;
+
+// Arena chunk (bump region)
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;
+    size_t used;
+} ArenaChunk;
+
+// Arena: bump allocation, everything released at once
+typedef struct Arena {
+    ArenaChunk* head;
+    size_t chunkSize;
+    AllocStats stats;
+} Arena;
+
+// Fixed-size block pool with free list, backed by an arena
+typedef struct Pool {
+    Arena arena;
+    size_t blockSize;
+    void* freeList;
+    AllocStats stats;
+} Pool;
+
+// Arena functions
+void arenaInit(Arena* a, size_t chunkSize);
+void* arenaAlloc(Arena* a, size_t size);
+void arenaReset(Arena* a);
+void arenaDestroy(Arena* a);
+
+// Pool functions
+void poolInit(Pool* p, size_t blockSize, size_t blocksPerChunk);
+void* poolAlloc(Pool* p);
+void poolFree(Pool* p, void* block);
+void poolDestroy(Pool* p);
+
+// Statistics
+void printAllocStats(const char* label, const AllocStats* s);
+
+#endif // ALLOCATOR_H
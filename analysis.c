@@ -0,0 +1,408 @@
+// --- FILE: analysis.c ---
+#include "analysis.h"
+#include "dijkstra.h"
+#include "simulation.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// City pair -> road index (-1 if no road), n x n row-major. Caller frees.
+static int* buildRoadIndex(const RoadStats roads[], int numRoads, int n) {
+    int* index = (int*)malloc(sizeof(int) * (n > 0 ? n * n : 1));
+    if (!index) {
+        fprintf(stderr, "Analysis memory failed\n");
+        exit(1);
+    }
+    memset(index, 0xFF, sizeof(int) * n * n);
+    for (int r = 0; r < numRoads; r++) {
+        index[roads[r].src * n + roads[r].dest] = r;
+        index[roads[r].dest * n + roads[r].src] = r;
+    }
+    return index;
+}
+
+// --- Bridges and Articulation Points ---
+// Iterative Tarjan DFS. A road is all edges between two cities (closeRoad
+// removes them together), so every edge back to the DFS parent is skipped.
+// cutOff[v] counts cities separated from the largest remaining piece.
+int findBridgesAndArticulationPoints(const Graph* g, RoadStats roads[], int numRoads,
+                                     unsigned int articulation[], int cutOff[]) {
+    int n = g->numCities;
+    int disc[MAX_CITIES], low[MAX_CITIES], size[MAX_CITIES], parent[MAX_CITIES];
+    int children[MAX_CITIES], comp[MAX_CITIES];
+    int sepSum[MAX_CITIES], sepMax[MAX_CITIES], compSize[MAX_CITIES];
+    const EdgeNode* iter[MAX_CITIES];
+    int stack[MAX_CITIES];
+    int* index = buildRoadIndex(roads, numRoads, n);
+
+    memset(articulation, 0, CITY_MASK_WORDS * sizeof(unsigned int));
+    for (int v = 0; v < n; v++) {
+        disc[v] = -1;
+        sepSum[v] = sepMax[v] = children[v] = 0;
+        cutOff[v] = 0;
+    }
+
+    int timer = 0, numComps = 0, bridges = 0;
+    for (int root = 0; root < n; root++) {
+        if (disc[root] != -1) continue;
+
+        int top = 0;
+        disc[root] = low[root] = timer++;
+        size[root] = 1;
+        parent[root] = -1;
+        iter[root] = g->adjList[root];
+        comp[root] = numComps;
+        stack[top++] = root;
+
+        while (top > 0) {
+            int u = stack[top - 1];
+            const EdgeNode* e = iter[u];
+            if (e) {
+                iter[u] = e->next;
+                int v = e->destCity;
+                if (v == parent[u]) continue;
+                if (disc[v] == -1) {
+                    disc[v] = low[v] = timer++;
+                    size[v] = 1;
+                    parent[v] = u;
+                    iter[v] = g->adjList[v];
+                    comp[v] = numComps;
+                    children[u]++;
+                    stack[top++] = v;
+                } else if (disc[v] < low[u]) {
+                    low[u] = disc[v];
+                }
+                continue;
+            }
+
+            // u finished: report to its parent
+            top--;
+            int p = parent[u];
+            if (p < 0) continue;
+            if (low[u] < low[p]) low[p] = low[u];
+            size[p] += size[u];
+            if (low[u] > disc[p] && index[p * n + u] >= 0) {
+                roads[index[p * n + u]].isBridge = 1;
+                bridges++;
+            }
+            if (low[u] >= disc[p]) {
+                sepSum[p] += size[u];
+                if (size[u] > sepMax[p]) sepMax[p] = size[u];
+            }
+        }
+        compSize[numComps++] = size[root];
+    }
+
+    for (int v = 0; v < n; v++) {
+        int isRoot = (parent[v] == -1);
+        if (isRoot ? children[v] < 2 : sepSum[v] == 0) continue;
+        CITY_MASK_SET(articulation, v);
+        int total = compSize[comp[v]] - 1;
+        int rest = total - sepSum[v];
+        int largest = (rest > sepMax[v]) ? rest : sepMax[v];
+        cutOff[v] = total - largest;
+    }
+    free(index);
+    return bridges;
+}
+
+// --- Edge Betweenness (Brandes) ---
+// One source: shortest-path DAG with path counts, then dependencies
+// accumulated in reverse settle order onto the roads of the DAG.
+// pred is caller-owned scratch with a predecessor mask per city.
+static void accumulateFromSource(Graph* g, int s, double credit[], const int index[],
+                                 unsigned int (*pred)[CITY_MASK_WORDS]) {
+    int n = g->numCities;
+    int dist[MAX_CITIES], order[MAX_CITIES], settledCount = 0;
+    double sigma[MAX_CITIES], delta[MAX_CITIES];
+    unsigned int settled[CITY_MASK_WORDS];
+    MinHeap* heap = createMinHeap(n);
+
+    memset(pred, 0, n * sizeof(pred[0]));
+    memset(settled, 0, sizeof(settled));
+    for (int v = 0; v < n; v++) {
+        dist[v] = INF;
+        sigma[v] = 0;
+        delta[v] = 0;
+        heap->array[v] = &heap->nodes[v];
+        heap->array[v]->vertex = v;
+        heap->array[v]->distance = INF;
+        heap->pos[v] = v;
+    }
+    heap->size = n;
+    dist[s] = 0;
+    sigma[s] = 1;
+    decreaseKey(heap, s, 0);
+
+    while (!isEmpty(heap)) {
+        int u = extractMin(heap)->vertex;
+        if (dist[u] == INF) break;
+        CITY_MASK_SET(settled, u);
+        order[settledCount++] = u;
+
+        for (EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            int v = e->destCity;
+            if (CITY_MASK_TEST(settled, v)) continue;
+            if (e->distance >= INF - dist[u]) continue;
+            int nd = dist[u] + e->distance;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                sigma[v] = sigma[u];
+                memset(pred[v], 0, sizeof(pred[v]));
+                CITY_MASK_SET(pred[v], u);
+                decreaseKey(heap, v, nd);
+            } else if (nd == dist[v] && !CITY_MASK_TEST(pred[v], u)) {
+                sigma[v] += sigma[u];
+                CITY_MASK_SET(pred[v], u);
+            }
+        }
+    }
+    freeMinHeap(heap);
+
+    for (int i = settledCount - 1; i > 0; i--) {
+        int w = order[i];
+        for (int v = 0; v < n; v++) {
+            if (!CITY_MASK_TEST(pred[w], v)) continue;
+            double c = sigma[v] / sigma[w] * (1.0 + delta[w]);
+            credit[index[v * n + w]] += c;
+            delta[v] += c;
+        }
+    }
+}
+
+// Exact (all sources) or sampled (sampleSources random sources, scaled up)
+void computeEdgeBetweenness(Graph* g, RoadStats roads[], int numRoads,
+                            int sampleSources, unsigned long long seed) {
+    int n = g->numCities;
+    int sources[MAX_CITIES];
+    int* index = buildRoadIndex(roads, numRoads, n);
+
+    for (int v = 0; v < n; v++) sources[v] = v;
+
+    int k = n;
+    if (sampleSources > 0 && sampleSources < n) {
+        SimRng rng;
+        seedRng(&rng, seed);
+        for (int i = 0; i < sampleSources; i++) {
+            int j = nextRange(&rng, i, n - 1);
+            int tmp = sources[i];
+            sources[i] = sources[j];
+            sources[j] = tmp;
+        }
+        k = sampleSources;
+    }
+    for (int r = 0; r < numRoads; r++) roads[r].betweenness = 0;
+
+    // Each pair is seen from both ends; sampling scales by n / k
+    double scale = (k > 0) ? (double)n / k / 2.0 : 0;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        double* credit = (double*)calloc(numRoads + 1, sizeof(double));
+        unsigned int (*pred)[CITY_MASK_WORDS] =
+            (unsigned int (*)[CITY_MASK_WORDS])malloc((n + 1) * sizeof(*pred));
+        if (!credit || !pred) {
+            fprintf(stderr, "Analysis memory failed\n");
+            exit(1);
+        }
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < k; i++)
+            accumulateFromSource(g, sources[i], credit, index, pred);
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        for (int r = 0; r < numRoads; r++)
+            roads[r].betweenness += credit[r] * scale;
+        free(credit);
+        free(pred);
+    }
+    free(index);
+}
+
+// --- Road Removal Impact ---
+// A closure can only change distances from sources whose shortest-path
+// tree uses the road (the road is tight: dist[a] + w == dist[b]), so only
+// those sources are searched again, on a view with the road closed.
+void computeRemovalImpact(Graph* g, RoadStats roads[], int numRoads) {
+    int n = g->numCities;
+    int (*base)[MAX_CITIES] = (int (*)[MAX_CITIES])malloc(sizeof(int) * MAX_CITIES * MAX_CITIES);
+    if (!base) {
+        fprintf(stderr, "Analysis memory failed\n");
+        exit(1);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int s = 0; s < n; s++) {
+        int parent[MAX_CITIES];
+        dijkstra(g, s, base[s], parent);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int r = 0; r < numRoads; r++) {
+        RoadStats* rs = &roads[r];
+        int a = rs->src, b = rs->dest;
+        int w = INF;
+        for (const EdgeNode* e = g->adjList[a]; e; e = e->next)
+            if (e->destCity == b && e->distance < w) w = e->distance;
+
+        long increase = 0;
+        int disconnected = 0, worst = 0;
+        Graph* view = NULL;
+        int dist[MAX_CITIES], parent[MAX_CITIES];
+
+        for (int s = 0; s < n; s++) {
+            if (base[s][a] == INF) continue;
+            if (w != base[s][b] - base[s][a] && w != base[s][a] - base[s][b])
+                continue;
+            if (!view) {
+                view = createGraphView(g);
+                closeRoad(view, a, b);
+            }
+            dijkstra(view, s, dist, parent);
+            for (int t = 0; t < n; t++) {
+                if (base[s][t] == INF) continue;
+                if (dist[t] == INF) {
+                    disconnected++;
+                    continue;
+                }
+                int extra = dist[t] - base[s][t];
+                increase += extra;
+                if (extra > worst) worst = extra;
+            }
+        }
+        if (view) freeGraph(view);
+
+        // Every affected pair was counted from both of its ends
+        rs->distanceIncrease = increase / 2;
+        rs->pairsDisconnected = disconnected / 2;
+        rs->maxIncrease = worst;
+    }
+    free(base);
+}
+
+// --- Full Analysis ---
+VulnerabilityReport* analyzeNetwork(Graph* g, int sampleSources, unsigned long long seed) {
+    VulnerabilityReport* r = (VulnerabilityReport*)calloc(1, sizeof(VulnerabilityReport));
+    if (!r) {
+        fprintf(stderr, "Analysis memory failed\n");
+        exit(1);
+    }
+    double start = nowMs();
+
+    r->numCities = g->numCities;
+    r->numRoads = collectRoads(g, NULL, NULL);
+    int* src = (int*)malloc((2 * r->numRoads + 1) * sizeof(int));
+    r->roads = (RoadStats*)calloc(r->numRoads + 1, sizeof(RoadStats));
+    if (!src || !r->roads) {
+        fprintf(stderr, "Analysis memory failed\n");
+        exit(1);
+    }
+    int* dest = src + r->numRoads;
+    collectRoads(g, src, dest);
+    for (int i = 0; i < r->numRoads; i++) {
+        r->roads[i].src = src[i];
+        r->roads[i].dest = dest[i];
+    }
+    free(src);
+
+    r->numBridges = findBridgesAndArticulationPoints(g, r->roads, r->numRoads,
+                                                     r->articulation, r->cutOff);
+    for (int v = 0; v < g->numCities; v++)
+        if (CITY_MASK_TEST(r->articulation, v)) r->numArticulation++;
+
+    r->sampledSources = (sampleSources > 0 && sampleSources < g->numCities)
+                        ? sampleSources : g->numCities;
+    computeEdgeBetweenness(g, r->roads, r->numRoads, sampleSources, seed);
+    computeRemovalImpact(g, r->roads, r->numRoads);
+
+    r->elapsedMs = nowMs() - start;
+    return r;
+}
+
+// Index of the best road not yet shown (by betweenness or by detour cost)
+static int nextBest(const VulnerabilityReport* r, const unsigned char shown[],
+                    int byImpact) {
+    int best = -1;
+    for (int i = 0; i < r->numRoads; i++) {
+        if (shown[i]) continue;
+        const RoadStats* x = &r->roads[i];
+        if (best < 0) { best = i; continue; }
+        const RoadStats* b = &r->roads[best];
+        int better = byImpact
+            ? (x->pairsDisconnected > b->pairsDisconnected ||
+               (x->pairsDisconnected == b->pairsDisconnected &&
+                x->distanceIncrease > b->distanceIncrease))
+            : x->betweenness > b->betweenness;
+        if (better) best = i;
+    }
+    return best;
+}
+
+// Print report
+void printVulnerabilityReport(const Graph* g, const VulnerabilityReport* r) {
+    printf("\nCities: %d | Roads: %d | Bridges: %d | Articulation cities: %d\n",
+           r->numCities, r->numRoads, r->numBridges, r->numArticulation);
+    printf("Betweenness sources: %d of %d%s | Time: %.2f ms\n",
+           r->sampledSources, r->numCities,
+           r->sampledSources < r->numCities ? " (sampled)" : "", r->elapsedMs);
+
+    printf("\nBridges (closing one splits the network):\n");
+    int any = 0;
+    for (int i = 0; i < r->numRoads; i++) {
+        if (!r->roads[i].isBridge) continue;
+        printf("  %s ↔ %s\n", g->cities.name[r->roads[i].src],
+               g->cities.name[r->roads[i].dest]);
+        any = 1;
+    }
+    if (!any) printf("  None\n");
+
+    printf("\nArticulation cities (failure isolates others):\n");
+    any = 0;
+    for (int v = 0; v < r->numCities; v++) {
+        if (!CITY_MASK_TEST(r->articulation, v)) continue;
+        printf("  %-15s cuts off %d cities\n", g->cities.name[v], r->cutOff[v]);
+        any = 1;
+    }
+    if (!any) printf("  None\n");
+
+    unsigned char* shown = (unsigned char*)malloc(r->numRoads + 1);
+    if (!shown) {
+        fprintf(stderr, "Analysis memory failed\n");
+        exit(1);
+    }
+    printf("\nBusiest roads (shortest paths through them):\n");
+    memset(shown, 0, r->numRoads);
+    for (int k = 0; k < CRITICAL_ITEMS_SHOWN && k < r->numRoads; k++) {
+        int i = nextBest(r, shown, 0);
+        shown[i] = 1;
+        printf("  %s ↔ %s | %.1f\n", g->cities.name[r->roads[i].src],
+               g->cities.name[r->roads[i].dest], r->roads[i].betweenness);
+    }
+
+    printf("\nCostliest closures:\n");
+    memset(shown, 0, r->numRoads);
+    for (int k = 0; k < CRITICAL_ITEMS_SHOWN && k < r->numRoads; k++) {
+        int i = nextBest(r, shown, 1);
+        shown[i] = 1;
+        const RoadStats* x = &r->roads[i];
+        printf("  %s ↔ %s | +%ld km total | worst +%d km | %d pairs cut\n",
+               g->cities.name[x->src], g->cities.name[x->dest],
+               x->distanceIncrease, x->maxIncrease, x->pairsDisconnected);
+    }
+    free(shown);
+}
+
+void freeVulnerabilityReport(VulnerabilityReport* r) {
+    if (!r) return;
+    free(r->roads);
+    free(r);
+}
@@ -0,0 +1,45 @@
+// --- FILE: analysis.h ---
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "graph.h"
+
+#define CRITICAL_ITEMS_SHOWN 5
+
+// Vulnerability figures for one undirected road
+typedef struct RoadStats {
+    int src;
+    int dest;
+    int isBridge;               // Closing it splits the network
+    double betweenness;         // Shortest paths (city pairs) using the road
+    long distanceIncrease;      // Extra km summed over city pairs when closed
+    int maxIncrease;            // Worst single-pair detour, km
+    int pairsDisconnected;      // City pairs left without a route
+} RoadStats;
+
+// Network-wide report
+typedef struct VulnerabilityReport {
+    int numCities;
+    int numRoads;
+    RoadStats* roads;
+    int numBridges;
+    int numArticulation;
+    unsigned int articulation[CITY_MASK_WORDS];
+    int cutOff[MAX_CITIES];     // Cities isolated from the rest if this city fails
+    int sampledSources;         // Betweenness sources used (numCities = exact)
+    double elapsedMs;
+} VulnerabilityReport;
+
+// Individual analyses (roads[] must come from collectRoads order)
+int findBridgesAndArticulationPoints(const Graph* g, RoadStats roads[], int numRoads,
+                                     unsigned int articulation[], int cutOff[]);
+void computeEdgeBetweenness(Graph* g, RoadStats roads[], int numRoads,
+                            int sampleSources, unsigned long long seed);
+void computeRemovalImpact(Graph* g, RoadStats roads[], int numRoads);
+
+// Full analysis; sampleSources <= 0 or >= numCities means exact betweenness
+VulnerabilityReport* analyzeNetwork(Graph* g, int sampleSources, unsigned long long seed);
+void printVulnerabilityReport(const Graph* g, const VulnerabilityReport* r);
+void freeVulnerabilityReport(VulnerabilityReport* r);
+
+#endif // ANALYSIS_H
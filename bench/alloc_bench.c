@@ -0,0 +1,217 @@
+// --- FILE: bench/alloc_bench.c ---
+// Construction and teardown of a large synthetic graph, status map and
+// heap set, with the original one-malloc-per-node path against the pool
+// and arena path the program now uses. Graph and map storage is capped
+// by config.h, so the same node types are linked into plain arrays of
+// lists here; the allocation pattern matches graph.c, resources.c and
+// dijkstra.c. Each structure and path runs in its own process: after
+// freeing millions of small blocks, glibc charges the next requests for
+// merging them, which would otherwise land on whatever runs next.
+#include "graph.h"
+#include "resources.h"
+#include "dijkstra.h"
+#include "allocator.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_CITIES 100000
+#define BENCH_ROADS 1000000         // Two edge nodes each
+#define BENCH_ENTRIES 1000000
+#define BENCH_HEAPS 1000
+#define BENCH_HEAP_SIZE 2000        // Largest advertised MAX_CITIES
+#define BENCH_REPEATS 5             // Best of, after the cold run
+
+typedef struct Timing {
+    double buildMs;
+    double freeMs;
+    double firstMs;     // Build plus free of the first (cold) run
+} Timing;
+
+static EdgeNode** adj;
+static HashEntry** buckets;
+static MinHeap** heaps;
+
+// Keep the best of repeated runs
+static void keepBest(Timing* best, double buildMs, double freeMs, int first) {
+    if (first) best->firstMs = buildMs + freeMs;
+    if (first || buildMs < best->buildMs) best->buildMs = buildMs;
+    if (first || freeMs < best->freeMs) best->freeMs = freeMs;
+}
+
+// Link one edge node at the front of a city's list
+static void linkEdge(EdgeNode* node, int src, int dest) {
+    node->destCity = dest;
+    node->distance = 1 + (src ^ dest) % 500;
+    node->maxLoad = 0;
+    node->profile = -1;
+    node->vehicleMask = 0xFF;
+    node->next = adj[src];
+    adj[src] = node;
+}
+
+// Link one entry at the front of its bucket
+static void linkEntry(HashEntry* entry, int i) {
+    entry->cityId = i;
+    entry->status = PENDING;
+    entry->resourcesAllocated = i % 500;
+    entry->donorId = DONOR_NONE;
+    entry->distance = 0;
+    entry->slot = i;
+    entry->dirty = 0;
+    entry->next = buckets[i % HASH_SIZE];
+    buckets[i % HASH_SIZE] = entry;
+}
+
+// --- Edges ---
+static void edgesMalloc(Timing* t, int first) {
+    double t0 = nowMs();
+    for (int r = 0; r < BENCH_ROADS; r++) {
+        int a = r % BENCH_CITIES, b = (int)((r * 7919L + 13) % BENCH_CITIES);
+        linkEdge((EdgeNode*)malloc(sizeof(EdgeNode)), a, b);
+        linkEdge((EdgeNode*)malloc(sizeof(EdgeNode)), b, a);
+    }
+    double t1 = nowMs();
+    for (int v = 0; v < BENCH_CITIES; v++) {
+        EdgeNode* e = adj[v];
+        while (e) {
+            EdgeNode* dead = e;
+            e = e->next;
+            free(dead);
+        }
+        adj[v] = NULL;
+    }
+    keepBest(t, t1 - t0, nowMs() - t1, first);
+}
+
+static void edgesPool(Timing* t, int first) {
+    Pool pool;
+    double t0 = nowMs();
+    poolInit(&pool, sizeof(EdgeNode), EDGES_PER_CHUNK);
+    for (int r = 0; r < BENCH_ROADS; r++) {
+        int a = r % BENCH_CITIES, b = (int)((r * 7919L + 13) % BENCH_CITIES);
+        linkEdge((EdgeNode*)poolAlloc(&pool), a, b);
+        linkEdge((EdgeNode*)poolAlloc(&pool), b, a);
+    }
+    double t1 = nowMs();
+    poolDestroy(&pool);
+    for (int v = 0; v < BENCH_CITIES; v++) adj[v] = NULL;
+    keepBest(t, t1 - t0, nowMs() - t1, first);
+}
+
+// --- Status entries ---
+static void entriesMalloc(Timing* t, int first) {
+    double t0 = nowMs();
+    for (int i = 0; i < BENCH_ENTRIES; i++)
+        linkEntry((HashEntry*)malloc(sizeof(HashEntry)), i);
+    double t1 = nowMs();
+    for (int b = 0; b < HASH_SIZE; b++) {
+        HashEntry* e = buckets[b];
+        while (e) {
+            HashEntry* dead = e;
+            e = e->next;
+            free(dead);
+        }
+        buckets[b] = NULL;
+    }
+    keepBest(t, t1 - t0, nowMs() - t1, first);
+}
+
+static void entriesPool(Timing* t, int first) {
+    Pool pool;
+    double t0 = nowMs();
+    poolInit(&pool, sizeof(HashEntry), HASH_ENTRIES_PER_CHUNK);
+    for (int i = 0; i < BENCH_ENTRIES; i++)
+        linkEntry((HashEntry*)poolAlloc(&pool), i);
+    double t1 = nowMs();
+    poolDestroy(&pool);
+    for (int b = 0; b < HASH_SIZE; b++) buckets[b] = NULL;
+    keepBest(t, t1 - t0, nowMs() - t1, first);
+}
+
+// --- Heaps ---
+// Original layout: heap, pos and array blocks plus one node per vertex
+static void heapsMalloc(Timing* t, int first) {
+    double t0 = nowMs();
+    for (int h = 0; h < BENCH_HEAPS; h++) {
+        MinHeap* heap = (MinHeap*)malloc(sizeof(MinHeap));
+        heap->pos = (int*)malloc(BENCH_HEAP_SIZE * sizeof(int));
+        heap->array = (MinHeapNode**)malloc(BENCH_HEAP_SIZE * sizeof(MinHeapNode*));
+        for (int v = 0; v < BENCH_HEAP_SIZE; v++) {
+            heap->array[v] = (MinHeapNode*)malloc(sizeof(MinHeapNode));
+            heap->array[v]->vertex = v;
+            heap->array[v]->distance = INF;
+            heap->pos[v] = v;
+        }
+        heap->size = heap->capacity = BENCH_HEAP_SIZE;
+        heaps[h] = heap;
+    }
+    double t1 = nowMs();
+    for (int h = 0; h < BENCH_HEAPS; h++) {
+        for (int v = 0; v < BENCH_HEAP_SIZE; v++) free(heaps[h]->array[v]);
+        free(heaps[h]->pos);
+        free(heaps[h]->array);
+        free(heaps[h]);
+    }
+    keepBest(t, t1 - t0, nowMs() - t1, first);
+}
+
+static void heapsArena(Timing* t, int first) {
+    double t0 = nowMs();
+    for (int h = 0; h < BENCH_HEAPS; h++) {
+        MinHeap* heap = createMinHeap(BENCH_HEAP_SIZE);
+        for (int v = 0; v < BENCH_HEAP_SIZE; v++) {
+            heap->array[v] = &heap->nodes[v];
+            heap->array[v]->vertex = v;
+            heap->array[v]->distance = INF;
+            heap->pos[v] = v;
+        }
+        heap->size = BENCH_HEAP_SIZE;
+        heaps[h] = heap;
+    }
+    double t1 = nowMs();
+    for (int h = 0; h < BENCH_HEAPS; h++) freeMinHeap(heaps[h]);
+    keepBest(t, t1 - t0, nowMs() - t1, first);
+}
+
+static void printRow(const char* label, const char* path, const Timing* t) {
+    printf("%-16s %-7s %10.1f %10.1f %10.1f %10.1f\n", label, path,
+           t->buildMs, t->freeMs, t->buildMs + t->freeMs, t->firstMs);
+}
+
+int main(int argc, char* argv[]) {
+    const char* structures[] = { "edges", "entries", "heaps" };
+    int which = -1;
+    for (int k = 0; argc > 2 && k < 3; k++)
+        if (strcmp(argv[2], structures[k]) == 0) which = k;
+    if (which < 0 || (strcmp(argv[1], "malloc") != 0 && strcmp(argv[1], "pool") != 0)) {
+        fprintf(stderr, "Usage: %s malloc|pool edges|entries|heaps\n", argv[0]);
+        return 1;
+    }
+    int pooled = strcmp(argv[1], "pool") == 0;
+
+    adj = (EdgeNode**)calloc(BENCH_CITIES, sizeof(EdgeNode*));
+    buckets = (HashEntry**)calloc(HASH_SIZE, sizeof(HashEntry*));
+    heaps = (MinHeap**)malloc(BENCH_HEAPS * sizeof(MinHeap*));
+    if (!adj || !buckets || !heaps) {
+        fprintf(stderr, "Benchmark memory failed\n");
+        exit(1);
+    }
+
+    Timing best = { 0, 0, 0 };
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        if (which == 0) pooled ? edgesPool(&best, r == 0) : edgesMalloc(&best, r == 0);
+        if (which == 1) pooled ? entriesPool(&best, r == 0) : entriesMalloc(&best, r == 0);
+        if (which == 2) pooled ? heapsArena(&best, r == 0) : heapsMalloc(&best, r == 0);
+    }
+
+    const char* labels[] = { "Edges 2M", "Entries 1M", "Heaps 1000x2000" };
+    const char* path = !pooled ? "malloc" : (which == 2 ? "arena" : "pool");
+    printRow(labels[which], path, &best);
+
+    free(adj);
+    free(buckets);
+    free(heaps);
+    return 0;
+}
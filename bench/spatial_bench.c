@@ -0,0 +1,107 @@
+// --- FILE: bench/spatial_bench.c ---
+// Query latency of the k-d tree at a million cities, against a linear scan.
+// Graph storage is capped at MAX_CITIES, so the index is built from raw
+// coordinates here; the tree and queries are the ones the program uses.
+#include "spatial.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_POINTS 1000000
+#define BENCH_QUERIES 10000
+#define BENCH_SCANS 200             // Linear scans are slow; fewer of them
+#define BENCH_RADIUS_KM 50.0
+#define BENCH_MAX_OUT 4096
+
+// Uniform in [lo, hi)
+static double randomIn(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (RAND_MAX + 1.0));
+}
+
+// Nearest point by checking every one
+static int linearNearest(const double lat[], const double lon[], int n,
+                         double qLat, double qLon, double* km) {
+    int best = -1;
+    double bestKm = 0;
+    for (int i = 0; i < n; i++) {
+        double d = greatCircleDistance(qLat, qLon, lat[i], lon[i]);
+        if (best < 0 || d < bestKm) {
+            best = i;
+            bestKm = d;
+        }
+    }
+    *km = bestKm;
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int n = (argc > 1) ? atoi(argv[1]) : BENCH_POINTS;
+    if (n <= 0) n = BENCH_POINTS;
+
+    double* lat = (double*)malloc(n * sizeof(double));
+    double* lon = (double*)malloc(n * sizeof(double));
+    double* qLat = (double*)malloc(BENCH_QUERIES * sizeof(double));
+    double* qLon = (double*)malloc(BENCH_QUERIES * sizeof(double));
+    int* ids = (int*)malloc(BENCH_MAX_OUT * sizeof(int));
+    double* km = (double*)malloc(BENCH_MAX_OUT * sizeof(double));
+    if (!lat || !lon || !qLat || !qLon || !ids || !km) {
+        fprintf(stderr, "Benchmark memory failed\n");
+        exit(1);
+    }
+
+    // Populated band of the globe, fixed seed so runs compare
+    srand(2024);
+    for (int i = 0; i < n; i++) {
+        lat[i] = randomIn(-55.0, 70.0);
+        lon[i] = randomIn(-180.0, 180.0);
+    }
+    for (int q = 0; q < BENCH_QUERIES; q++) {
+        qLat[q] = randomIn(-55.0, 70.0);
+        qLon[q] = randomIn(-180.0, 180.0);
+    }
+
+    double t0 = nowMs();
+    SpatialIndex* idx = createSpatialIndexFromPoints(lat, lon, n);
+    double buildMs = nowMs() - t0;
+    printf("Cities: %d | Build: %.1f ms\n", n, buildMs);
+
+    long found = 0;
+    t0 = nowMs();
+    for (int q = 0; q < BENCH_QUERIES; q++)
+        found += findKNearestCities(idx, qLat[q], qLon[q], 1, ids, km);
+    printf("Nearest (k=1):  %.2f us/query\n", (nowMs() - t0) * 1000.0 / BENCH_QUERIES);
+
+    t0 = nowMs();
+    for (int q = 0; q < BENCH_QUERIES; q++)
+        found += findKNearestCities(idx, qLat[q], qLon[q], 10, ids, km);
+    printf("Nearest (k=10): %.2f us/query\n", (nowMs() - t0) * 1000.0 / BENCH_QUERIES);
+
+    long inRadius = 0;
+    t0 = nowMs();
+    for (int q = 0; q < BENCH_QUERIES; q++)
+        inRadius += findCitiesWithinRadius(idx, qLat[q], qLon[q], BENCH_RADIUS_KM,
+                                           ids, km, BENCH_MAX_OUT);
+    printf("Radius %.0f km:  %.2f us/query (%.1f cities on average)\n", BENCH_RADIUS_KM,
+           (nowMs() - t0) * 1000.0 / BENCH_QUERIES, (double)inRadius / BENCH_QUERIES);
+
+    // Linear scan baseline, also checks the tree's answers
+    int mismatches = 0;
+    double treeKm, scanKm;
+    t0 = nowMs();
+    for (int q = 0; q < BENCH_SCANS; q++) {
+        linearNearest(lat, lon, n, qLat[q], qLon[q], &scanKm);
+        snapToNearestCity(idx, qLat[q], qLon[q], &treeKm);
+        if (treeKm > scanKm + 1e-9) mismatches++;
+    }
+    printf("Linear scan:    %.2f us/query | Mismatches: %d\n",
+           (nowMs() - t0) * 1000.0 / BENCH_SCANS, mismatches);
+
+    freeSpatialIndex(idx);
+    free(lat);
+    free(lon);
+    free(qLat);
+    free(qLon);
+    free(ids);
+    free(km);
+    return (found > 0 && mismatches == 0) ? 0 : 1;
+}
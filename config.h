@@ -0,0 +1,46 @@
+// --- FILE: config.h ---
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Build-time capacities and tuning knobs. Each can be overridden from the
+// compiler command line, e.g.
+//   make -f markfile clean-obj
+//   make -f markfile CONFIG="-DMAX_CITIES=200 -DHEAP_ARITY=4"
+
+// Cities in the network (sizes every per-city array and bitmask)
+#ifndef MAX_CITIES
+#define MAX_CITIES 50
+#endif
+
+// Pending requests the priority queue can hold
+#ifndef MAX_REQUESTS
+#define MAX_REQUESTS 1000
+#endif
+
+// Buckets in the status hash map
+#ifndef HASH_SIZE
+#define HASH_SIZE 5000
+#endif
+
+// Resource types tracked per city by the inventory ledger
+#ifndef MAX_COMMODITIES
+#define MAX_COMMODITIES 256
+#endif
+
+// Children per node in Dijkstra's min-heap (2 = binary heap). Wider heaps
+// are shallower, trading cheaper decrease-key for costlier extract-min.
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 2
+#endif
+
+#if MAX_CITIES < 2
+#error "MAX_CITIES must be at least 2"
+#endif
+#if MAX_COMMODITIES < 1
+#error "MAX_COMMODITIES must be at least 1"
+#endif
+#if HEAP_ARITY < 2
+#error "HEAP_ARITY must be at least 2"
+#endif
+
+#endif // CONFIG_H
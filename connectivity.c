@@ -0,0 +1,295 @@
+// --- FILE: connectivity.c ---
+#include "connectivity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Create empty index
+ConnectivityIndex* createConnectivityIndex(void) {
+    ConnectivityIndex* idx = (ConnectivityIndex*)malloc(sizeof(ConnectivityIndex));
+    if (!idx) {
+        fprintf(stderr, "Connectivity index memory failed\n");
+        exit(1);
+    }
+    idx->version = 0;
+    idx->numCities = 0;
+    idx->numComponents = 0;
+    idx->numFree = MAX_CITIES;
+    for (int i = 0; i < MAX_CITIES; i++)
+        idx->freeIds[i] = MAX_CITIES - 1 - i;
+    idx->stats = (ConnectivityStats){0};
+    return idx;
+}
+
+void freeConnectivityIndex(ConnectivityIndex* idx) {
+    free(idx);
+}
+
+// --- Component Lists ---
+static int newComponent(ConnectivityIndex* idx, int city) {
+    int id = idx->freeIds[--idx->numFree];
+    idx->component[city] = id;
+    idx->size[id] = 1;
+    idx->head[id] = city;
+    idx->next[city] = idx->prev[city] = city;
+    idx->numComponents++;
+    return id;
+}
+
+static void releaseComponent(ConnectivityIndex* idx, int id) {
+    idx->freeIds[idx->numFree++] = id;
+    idx->numComponents--;
+}
+
+// Unlink a city from its component's member list
+static void detach(ConnectivityIndex* idx, int city) {
+    int id = idx->component[city];
+    if (idx->head[id] == city) idx->head[id] = idx->next[city];
+    idx->next[idx->prev[city]] = idx->next[city];
+    idx->prev[idx->next[city]] = idx->prev[city];
+    idx->size[id]--;
+}
+
+// Insert a city into a component's member list
+static void attach(ConnectivityIndex* idx, int city, int id) {
+    int h = idx->head[id];
+    idx->component[city] = id;
+    idx->next[city] = h;
+    idx->prev[city] = idx->prev[h];
+    idx->next[idx->prev[h]] = city;
+    idx->prev[h] = city;
+    idx->size[id]++;
+}
+
+// Union by size: relabel the smaller component and splice the lists
+static void mergeComponents(ConnectivityIndex* idx, int a, int b) {
+    int ca = idx->component[a], cb = idx->component[b];
+    if (ca == cb) return;
+    if (idx->size[ca] < idx->size[cb]) {
+        int t = ca;
+        ca = cb;
+        cb = t;
+    }
+
+    int first = idx->head[cb], c = first;
+    do {
+        idx->component[c] = ca;
+        c = idx->next[c];
+    } while (c != first);
+
+    int ha = idx->head[ca], hb = first;
+    int ta = idx->prev[ha], tb = idx->prev[hb];
+    idx->next[ta] = hb;
+    idx->prev[hb] = ta;
+    idx->next[tb] = ha;
+    idx->prev[ha] = tb;
+    idx->size[ca] += idx->size[cb];
+    releaseComponent(idx, cb);
+    idx->stats.unions++;
+}
+
+// After closing a-b: search from both ends in lockstep. If the searches
+// meet, nothing changed. If one runs dry first, its (smaller) side is cut
+// off and moves to a new component. Cost is bounded by the smaller side.
+static void splitIfDisconnected(ConnectivityIndex* idx, const Graph* g, int a, int b) {
+    if (a == b || idx->component[a] != idx->component[b]) return;
+    idx->stats.splitChecks++;
+
+    int queue[2][MAX_CITIES], headQ[2] = {0, 0}, tailQ[2] = {0, 0};
+    unsigned int seen[2][CITY_MASK_WORDS];
+    const EdgeNode* iter[2] = {NULL, NULL};
+    memset(seen, 0, sizeof(seen));
+
+    queue[0][tailQ[0]++] = a;
+    queue[1][tailQ[1]++] = b;
+    CITY_MASK_SET(seen[0], a);
+    CITY_MASK_SET(seen[1], b);
+    iter[0] = g->adjList[a];
+    iter[1] = g->adjList[b];
+
+    int cutSide = -1;
+    for (;;) {
+        for (int side = 0; side < 2; side++) {
+            // Advance one edge; move to the next queued city when exhausted
+            while (!iter[side]) {
+                if (++headQ[side] >= tailQ[side]) {
+                    cutSide = side;
+                    break;
+                }
+                iter[side] = g->adjList[queue[side][headQ[side]]];
+                idx->stats.searchSteps++;
+            }
+            if (cutSide >= 0) break;
+
+            int v = iter[side]->destCity;
+            iter[side] = iter[side]->next;
+            if (CITY_MASK_TEST(seen[1 - side], v)) return;
+            if (!CITY_MASK_TEST(seen[side], v)) {
+                CITY_MASK_SET(seen[side], v);
+                queue[side][tailQ[side]++] = v;
+            }
+        }
+        if (cutSide >= 0) break;
+    }
+
+    // Move the exhausted side into a fresh component
+    const int* members = queue[cutSide];
+    detach(idx, members[0]);
+    newComponent(idx, members[0]);
+    for (int i = 1; i < tailQ[cutSide]; i++) {
+        detach(idx, members[i]);
+        attach(idx, members[i], idx->component[members[0]]);
+    }
+    idx->stats.splits++;
+}
+
+// Full rebuild by breadth-first labelling
+static void rebuildIndex(ConnectivityIndex* idx, const Graph* g) {
+    int queue[MAX_CITIES];
+    unsigned int seen[CITY_MASK_WORDS];
+    memset(seen, 0, sizeof(seen));
+
+    idx->numComponents = 0;
+    idx->numFree = MAX_CITIES;
+    for (int i = 0; i < MAX_CITIES; i++)
+        idx->freeIds[i] = MAX_CITIES - 1 - i;
+
+    for (int s = 0; s < g->numCities; s++) {
+        if (CITY_MASK_TEST(seen, s)) continue;
+        int id = newComponent(idx, s);
+        int qh = 0, qt = 0;
+        queue[qt++] = s;
+        CITY_MASK_SET(seen, s);
+        while (qh < qt) {
+            int u = queue[qh++];
+            for (const EdgeNode* e = g->adjList[u]; e; e = e->next) {
+                int v = e->destCity;
+                if (CITY_MASK_TEST(seen, v)) continue;
+                CITY_MASK_SET(seen, v);
+                attach(idx, v, id);
+                queue[qt++] = v;
+            }
+        }
+    }
+    idx->numCities = g->numCities;
+    idx->version = g->version;
+    idx->stats.rebuilds++;
+}
+
+// Replay edits since the index was last synced. A closure is searched
+// against the current graph, which is only valid when it is the newest
+// pending edit; otherwise (or when the log has wrapped) rebuild.
+static void syncIndex(ConnectivityIndex* idx, Graph* g) {
+    if (idx->version == g->version) return;
+
+    unsigned int pending = g->version - idx->version;
+    int replay = (pending < EDIT_LOG_SIZE);
+    for (unsigned int v = idx->version + 1; replay && v < g->version; v++) {
+        const GraphEdit* e = getGraphEdit(g, v);
+        if (!e || e->kind == EDIT_CLOSE_ROAD) replay = 0;
+    }
+    if (!replay) {
+        rebuildIndex(idx, g);
+        return;
+    }
+
+    for (unsigned int v = idx->version + 1; v <= g->version; v++) {
+        const GraphEdit* e = getGraphEdit(g, v);
+        switch (e->kind) {
+            case EDIT_ADD_CITY:
+                newComponent(idx, e->src);
+                idx->numCities = e->src + 1;
+                break;
+            case EDIT_ADD_ROAD:
+                mergeComponents(idx, e->src, e->dest);
+                break;
+            case EDIT_CLOSE_ROAD:
+                splitIfDisconnected(idx, g, e->src, e->dest);
+                break;
+            case EDIT_RESTRICT_ROAD:
+                break;
+        }
+    }
+    idx->version = g->version;
+}
+
+// Lazily created index owned by the graph, brought up to date
+ConnectivityIndex* getConnectivityIndex(Graph* g) {
+    if (!g->connectivity) {
+        g->connectivity = createConnectivityIndex();
+        rebuildIndex(g->connectivity, g);
+    }
+    syncIndex(g->connectivity, g);
+    return g->connectivity;
+}
+
+// --- Queries ---
+int citiesConnected(Graph* g, int a, int b) {
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    return idx->component[a] == idx->component[b];
+}
+
+int componentSize(Graph* g, int city) {
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    return idx->size[idx->component[city]];
+}
+
+// Component holding the most cities (ties: lowest city id)
+int largestComponent(const ConnectivityIndex* idx) {
+    int best = -1;
+    for (int i = 0; i < idx->numCities; i++) {
+        int c = idx->component[i];
+        if (best < 0 || idx->size[c] > idx->size[best]) best = c;
+    }
+    return best;
+}
+
+// Mask of cities reachable from city (itself included); returns the count
+int componentMask(Graph* g, int city, unsigned int mask[]) {
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    memset(mask, 0, CITY_MASK_WORDS * sizeof(unsigned int));
+    int id = idx->component[city], first = idx->head[id], c = first;
+    do {
+        CITY_MASK_SET(mask, c);
+        c = idx->next[c];
+    } while (c != first);
+    return idx->size[id];
+}
+
+// --- Reporting ---
+void printConnectivityReport(Graph* g) {
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    int main = largestComponent(idx);
+
+    printf("Components: %d | Main network: %d of %d cities\n",
+           idx->numComponents, main >= 0 ? idx->size[main] : 0, idx->numCities);
+    if (idx->numComponents <= 1) {
+        printf("\nEvery city can reach every other city.\n");
+        return;
+    }
+
+    printf("\nCut off from the main network:\n");
+    unsigned int listed[CITY_MASK_WORDS] = {0};
+    for (int i = 0; i < idx->numCities; i++) {
+        int id = idx->component[i];
+        if (id == main || CITY_MASK_TEST(listed, i)) continue;
+
+        printf("  [");
+        int first = idx->head[id], c = first;
+        do {
+            printf("%s%s", c == first ? "" : ", ", g->cities.name[c]);
+            CITY_MASK_SET(listed, c);
+            c = idx->next[c];
+        } while (c != first);
+        printf("]\n");
+    }
+}
+
+void printConnectivityStats(const ConnectivityIndex* idx) {
+    printf("Connectivity   | Components: %d | Version: %u\n",
+           idx->numComponents, idx->version);
+    printf("%-14s | Unions: %lu | Split checks: %lu | Splits: %lu\n", "",
+           idx->stats.unions, idx->stats.splitChecks, idx->stats.splits);
+    printf("%-14s | Search steps: %lu | Rebuilds: %lu\n", "",
+           idx->stats.searchSteps, idx->stats.rebuilds);
+}
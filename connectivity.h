@@ -0,0 +1,48 @@
+// --- FILE: connectivity.h ---
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include "graph.h"
+
+// Index maintenance metrics
+typedef struct ConnectivityStats {
+    unsigned long unions;           // Components merged by new roads
+    unsigned long splitChecks;      // Closures searched for a split
+    unsigned long splits;           // Closures that did split a component
+    unsigned long searchSteps;      // Cities expanded by split searches
+    unsigned long rebuilds;
+} ConnectivityStats;
+
+// Connected components, kept in step with the graph's edit log.
+// Component ids are small integers recycled through a free list;
+// members of each component form a circular doubly linked list.
+typedef struct ConnectivityIndex {
+    unsigned int version;           // Graph version the index reflects
+    int numCities;
+    int numComponents;
+    int component[MAX_CITIES];      // City -> component id
+    int size[MAX_CITIES];           // Component id -> number of cities
+    int head[MAX_CITIES];           // Component id -> one member city
+    int next[MAX_CITIES];
+    int prev[MAX_CITIES];
+    int freeIds[MAX_CITIES];
+    int numFree;
+    ConnectivityStats stats;
+} ConnectivityIndex;
+
+// Index lifecycle
+ConnectivityIndex* createConnectivityIndex(void);
+ConnectivityIndex* getConnectivityIndex(Graph* g);
+void freeConnectivityIndex(ConnectivityIndex* idx);
+
+// O(1) queries (after the index has caught up with the graph)
+int citiesConnected(Graph* g, int a, int b);
+int componentSize(Graph* g, int city);
+int largestComponent(const ConnectivityIndex* idx);
+int componentMask(Graph* g, int city, unsigned int mask[]);
+
+// Reporting
+void printConnectivityReport(Graph* g);
+void printConnectivityStats(const ConnectivityIndex* idx);
+
+#endif // CONNECTIVITY_H
@@ -0,0 +1,529 @@
+// --- FILE: convoy.c ---
+#include "convoy.h"
+#include "dijkstra.h"
+#include "distcache.h"
+#include "timeroute.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Trucks of one class at one depot plan together. Their legs are routed
+// for the fleet's largest truck fully loaded, so every trip is legal.
+typedef struct {
+    int depot;
+    VehicleClass vehicle;
+    int maxLoad;
+    int table;              // Distance table for (vehicle, maxLoad)
+} Fleet;
+
+// Road distances for one vehicle class and load, one row per needed city
+typedef struct {
+    VehicleClass vehicle;
+    int load;
+    int* dm;
+} DistanceTable;
+
+// Planning workspace shared by the helpers below
+typedef struct {
+    int n;                  // Cities
+    int* row;               // City -> row in every table (-1 if not needed)
+    int* dm;                // Table in use (the current fleet's)
+    ConvoyPlan* plan;
+    Fleet* fleets;
+    DistanceTable* tables;
+    int* routeCap;          // Stop capacity of each route buffer
+    int* routeMaxLoad;      // Load limit of each route (fleet's largest truck)
+    int* routeFleet;        // Fleet running each route
+} Workspace;
+
+#define DM(w, a, b) ((w)->dm[(w)->row[a] * (w)->n + (b)])
+
+// Distance table of the fleet running route r
+static int* routeTable(const Workspace* w, int r) {
+    return w->tables[w->fleets[w->routeFleet[r]].table].dm;
+}
+
+// Saving for joining two stops on one trip
+typedef struct {
+    int i, j;
+    int saving;
+} Saving;
+
+static int compareSavings(const void* a, const void* b) {
+    const Saving* x = (const Saving*)a;
+    const Saving* y = (const Saving*)b;
+    return (y->saving > x->saving) - (y->saving < x->saving);
+}
+
+// City visited at position k of a route (depot at both ends)
+static int cityAt(const Workspace* w, const ConvoyRoute* r, int k) {
+    if (k < 0 || k >= r->numStops) return r->depotCity;
+    return w->plan->stops[r->stops[k]].cityId;
+}
+
+static int routeLength(const Workspace* w, const ConvoyRoute* r) {
+    int len = 0;
+    for (int k = 0; k <= r->numStops; k++)
+        len += DM(w, cityAt(w, r, k - 1), cityAt(w, r, k));
+    return len;
+}
+
+// Reverse stops[i..j]
+static void reverseStops(int* stops, int i, int j) {
+    while (i < j) {
+        int t = stops[i];
+        stops[i++] = stops[j];
+        stops[j--] = t;
+    }
+}
+
+// 2-opt within one route; returns 1 if the route improved
+static int twoOpt(const Workspace* w, ConvoyRoute* r) {
+    int improved = 0, again = 1;
+    while (again) {
+        again = 0;
+        for (int i = 0; i < r->numStops - 1; i++) {
+            for (int j = i + 1; j < r->numStops; j++) {
+                int a = cityAt(w, r, i - 1), b = cityAt(w, r, i);
+                int c = cityAt(w, r, j), d = cityAt(w, r, j + 1);
+                long delta = (long)DM(w, a, c) + DM(w, b, d) - DM(w, a, b) - DM(w, c, d);
+                if (delta < 0) {
+                    reverseStops(r->stops, i, j);
+                    improved = again = 1;
+                }
+            }
+        }
+    }
+    return improved;
+}
+
+// Or-opt within one route: move a segment of 1-3 stops elsewhere
+static int orOpt(const Workspace* w, ConvoyRoute* r) {
+    int improved = 0;
+    int tmp[3];
+    for (int len = 1; len <= 3; len++) {
+        for (int i = 0; i + len <= r->numStops; i++) {
+            int a = cityAt(w, r, i - 1), s = cityAt(w, r, i);
+            int e = cityAt(w, r, i + len - 1), b = cityAt(w, r, i + len);
+            long removeGain = (long)DM(w, a, s) + DM(w, e, b) - DM(w, a, b);
+
+            // Positions in the route with the segment taken out
+            int rest = r->numStops - len;
+            for (int p = 0; p <= rest; p++) {
+                if (p == i) continue;
+                int before = (p == 0) ? r->depotCity
+                           : cityAt(w, r, (p - 1 < i) ? p - 1 : p - 1 + len);
+                int after = (p == rest) ? r->depotCity
+                          : cityAt(w, r, (p < i) ? p : p + len);
+                long addCost = (long)DM(w, before, s) + DM(w, e, after) - DM(w, before, after);
+                if (addCost < removeGain) {
+                    memcpy(tmp, &r->stops[i], len * sizeof(int));
+                    memmove(&r->stops[i], &r->stops[i + len],
+                            (r->numStops - i - len) * sizeof(int));
+                    memmove(&r->stops[p + len], &r->stops[p], (rest - p) * sizeof(int));
+                    memcpy(&r->stops[p], tmp, len * sizeof(int));
+                    improved = 1;
+                    break;
+                }
+            }
+        }
+    }
+    return improved;
+}
+
+// Relocate single stops between routes of the same fleet
+static int relocateBetweenRoutes(Workspace* w) {
+    ConvoyPlan* plan = w->plan;
+    int improved = 0;
+    for (int ra = 0; ra < plan->numRoutes; ra++) {
+        ConvoyRoute* A = &plan->routes[ra];
+        w->dm = routeTable(w, ra);
+        for (int i = 0; i < A->numStops; i++) {
+            int stop = A->stops[i];
+            int demand = plan->stops[stop].demand;
+            int s = plan->stops[stop].cityId;
+            int a = cityAt(w, A, i - 1), b = cityAt(w, A, i + 1);
+            long removeGain = (long)DM(w, a, s) + DM(w, s, b) - DM(w, a, b);
+
+            int bestRoute = -1, bestPos = -1;
+            long bestCost = removeGain;
+            for (int rb = 0; rb < plan->numRoutes; rb++) {
+                ConvoyRoute* B = &plan->routes[rb];
+                if (rb == ra || w->routeFleet[rb] != w->routeFleet[ra] || B->numStops == 0 ||
+                    B->load + demand > w->routeMaxLoad[rb] ||
+                    B->numStops >= w->routeCap[rb])
+                    continue;
+                for (int p = 0; p <= B->numStops; p++) {
+                    int x = cityAt(w, B, p - 1), y = cityAt(w, B, p);
+                    long add = (long)DM(w, x, s) + DM(w, s, y) - DM(w, x, y);
+                    if (add < bestCost) {
+                        bestCost = add;
+                        bestRoute = rb;
+                        bestPos = p;
+                    }
+                }
+            }
+
+            if (bestRoute != -1) {
+                ConvoyRoute* B = &plan->routes[bestRoute];
+                memmove(&A->stops[i], &A->stops[i + 1], (A->numStops - i - 1) * sizeof(int));
+                A->numStops--;
+                A->load -= demand;
+                memmove(&B->stops[bestPos + 1], &B->stops[bestPos],
+                        (B->numStops - bestPos) * sizeof(int));
+                B->stops[bestPos] = stop;
+                B->numStops++;
+                B->load += demand;
+                improved = 1;
+                i--;
+            }
+        }
+    }
+    return improved;
+}
+
+// Clarke-Wright savings for the stops assigned to one fleet
+static void buildFleetRoutes(Workspace* w, int f, const int* members, int m) {
+    ConvoyPlan* plan = w->plan;
+    int depot = w->fleets[f].depot, maxLoad = w->fleets[f].maxLoad;
+    w->dm = w->tables[w->fleets[f].table].dm;
+    int* next = (int*)malloc(m * sizeof(int));
+    int* prev = (int*)malloc(m * sizeof(int));
+    int* owner = (int*)malloc(m * sizeof(int));
+    int* head = (int*)malloc(m * sizeof(int));
+    int* tail = (int*)malloc(m * sizeof(int));
+    int* load = (int*)malloc(m * sizeof(int));
+    Saving* savings = (Saving*)malloc((m > 1 ? (size_t)m * (m - 1) / 2 : 1) * sizeof(Saving));
+    if (!next || !prev || !owner || !head || !tail || !load || !savings) {
+        fprintf(stderr, "Convoy planning memory failed\n");
+        exit(1);
+    }
+
+    for (int k = 0; k < m; k++) {
+        next[k] = prev[k] = -1;
+        owner[k] = head[k] = tail[k] = k;
+        load[k] = plan->stops[members[k]].demand;
+    }
+
+    int numSavings = 0;
+    for (int i = 0; i < m; i++) {
+        int ci = plan->stops[members[i]].cityId;
+        for (int j = i + 1; j < m; j++) {
+            int cj = plan->stops[members[j]].cityId;
+            savings[numSavings].i = i;
+            savings[numSavings].j = j;
+            savings[numSavings].saving = DM(w, depot, ci) + DM(w, depot, cj) - DM(w, ci, cj);
+            numSavings++;
+        }
+    }
+    qsort(savings, numSavings, sizeof(Saving), compareSavings);
+
+    for (int k = 0; k < numSavings; k++) {
+        int i = savings[k].i, j = savings[k].j;
+        int A = owner[i], B = owner[j];
+        if (A == B || savings[k].saving < 0 || load[A] + load[B] > maxLoad) continue;
+        if ((head[A] != i && tail[A] != i) || (head[B] != j && tail[B] != j)) continue;
+
+        // Orient so that i ends A and j starts B
+        if (tail[A] != i) {
+            for (int x = head[A]; x != -1; x = prev[x]) {
+                int t = next[x]; next[x] = prev[x]; prev[x] = t;
+            }
+            int t = head[A]; head[A] = tail[A]; tail[A] = t;
+        }
+        if (head[B] != j) {
+            for (int x = head[B]; x != -1; x = prev[x]) {
+                int t = next[x]; next[x] = prev[x]; prev[x] = t;
+            }
+            int t = head[B]; head[B] = tail[B]; tail[B] = t;
+        }
+
+        next[i] = j;
+        prev[j] = i;
+        for (int x = j; x != -1; x = next[x]) owner[x] = A;
+        tail[A] = tail[B];
+        load[A] += load[B];
+    }
+
+    for (int k = 0; k < m; k++) {
+        if (owner[k] != k) continue;
+        int r = plan->numRoutes++;
+        ConvoyRoute* route = &plan->routes[r];
+        route->truck = -1;
+        route->trip = 0;
+        route->depotCity = depot;
+        route->vehicle = w->fleets[f].vehicle;
+        route->numStops = 0;
+        route->load = load[k];
+        route->length = 0;
+        route->stops = (int*)arenaAlloc(&plan->arena, m * sizeof(int));
+        w->routeCap[r] = m;
+        w->routeMaxLoad[r] = maxLoad;
+        w->routeFleet[r] = f;
+        for (int x = head[k]; x != -1; x = next[x])
+            route->stops[route->numStops++] = members[x];
+    }
+
+    free(next); free(prev); free(owner);
+    free(head); free(tail); free(load); free(savings);
+}
+
+// Plan capacitated multi-stop convoys for pending requests
+ConvoyPlan* planConvoys(Graph* g, const Truck trucks[], int numTrucks,
+                        const CityRequest requests[], int numRequests,
+                        double timeBudgetMs) {
+    double start = nowMs();
+    int n = g->numCities;
+    if (numTrucks > MAX_TRUCKS) numTrucks = MAX_TRUCKS;
+
+    ConvoyPlan* plan = (ConvoyPlan*)malloc(sizeof(ConvoyPlan));
+    if (!plan) {
+        fprintf(stderr, "Convoy planning memory failed\n");
+        exit(1);
+    }
+    memset(plan, 0, sizeof(ConvoyPlan));
+    arenaInit(&plan->arena, 0);
+
+    // Fleets, and one distance table per (vehicle, load) they need
+    Fleet fleets[MAX_TRUCKS];
+    DistanceTable tables[MAX_TRUCKS];
+    int numFleets = 0, numTables = 0;
+    for (int t = 0; t < numTrucks; t++) {
+        int f = 0;
+        while (f < numFleets && (fleets[f].depot != trucks[t].depotCity ||
+                                 fleets[f].vehicle != trucks[t].vehicle))
+            f++;
+        if (f == numFleets) {
+            fleets[f].depot = trucks[t].depotCity;
+            fleets[f].vehicle = trucks[t].vehicle;
+            fleets[f].maxLoad = 0;
+            numFleets++;
+        }
+        if (trucks[t].capacity > fleets[f].maxLoad) fleets[f].maxLoad = trucks[t].capacity;
+    }
+    for (int f = 0; f < numFleets; f++) {
+        int k = 0;
+        while (k < numTables && (tables[k].vehicle != fleets[f].vehicle ||
+                                 tables[k].load != fleets[f].maxLoad))
+            k++;
+        if (k == numTables) {
+            tables[k].vehicle = fleets[f].vehicle;
+            tables[k].load = fleets[f].maxLoad;
+            numTables++;
+        }
+        fleets[f].table = k;
+    }
+
+    // Distance rows for depots and request cities
+    int needed[MAX_CITIES], numNeeded = 0;
+    unsigned int seen[CITY_MASK_WORDS] = {0};
+    for (int f = 0; f < numFleets; f++) {
+        int d = fleets[f].depot;
+        if (!CITY_MASK_TEST(seen, d)) { CITY_MASK_SET(seen, d); needed[numNeeded++] = d; }
+    }
+    for (int q = 0; q < numRequests; q++) {
+        int c = requests[q].cityId;
+        if (!CITY_MASK_TEST(seen, c)) { CITY_MASK_SET(seen, c); needed[numNeeded++] = c; }
+    }
+
+    Workspace w;
+    w.n = n;
+    w.plan = plan;
+    w.fleets = fleets;
+    w.tables = tables;
+    w.row = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (!w.row) {
+        fprintf(stderr, "Convoy planning memory failed\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) w.row[i] = -1;
+    for (int k = 0; k < numNeeded; k++) w.row[needed[k]] = k;
+    for (int k = 0; k < numTables; k++) {
+        tables[k].dm = (int*)malloc(((size_t)numNeeded * n + 1) * sizeof(int));
+        if (!tables[k].dm) {
+            fprintf(stderr, "Convoy planning memory failed\n");
+            exit(1);
+        }
+    }
+
+    getDistanceCache(g);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int job = 0; job < numTables * numNeeded; job++) {
+        const DistanceTable* t = &tables[job / numNeeded];
+        int k = job % numNeeded;
+        int parent[MAX_CITIES];
+        dijkstraForVehicle(g, needed[k], t->vehicle, t->load, &t->dm[(size_t)k * n], parent);
+    }
+
+    // Assign each request to its nearest fleet, split to truck capacity
+    int* fleetOf = (int*)malloc((numRequests > 0 ? numRequests : 1) * sizeof(int));
+    int totalStops = 0, bestDist = INF;
+    for (int q = 0; q < numRequests; q++) {
+        int c = requests[q].cityId, best = -1;
+        for (int f = 0; f < numFleets; f++) {
+            w.dm = tables[fleets[f].table].dm;
+            int d = DM(&w, fleets[f].depot, c);
+            if (d < INF && (best == -1 || d < bestDist)) {
+                best = f;
+                bestDist = d;
+            }
+        }
+        fleetOf[q] = best;
+        int cap = (best == -1) ? requests[q].resourcesNeeded : fleets[best].maxLoad;
+        totalStops += (requests[q].resourcesNeeded + cap - 1) / cap;
+    }
+
+    plan->stops = (ConvoyStop*)arenaAlloc(&plan->arena, (totalStops + 1) * sizeof(ConvoyStop));
+    plan->unserved = (int*)arenaAlloc(&plan->arena, (totalStops + 1) * sizeof(int));
+    plan->routes = (ConvoyRoute*)arenaAlloc(&plan->arena, (totalStops + 1) * sizeof(ConvoyRoute));
+    w.routeCap = (int*)malloc((totalStops + 1) * sizeof(int));
+    w.routeMaxLoad = (int*)malloc((totalStops + 1) * sizeof(int));
+    w.routeFleet = (int*)malloc((totalStops + 1) * sizeof(int));
+    int* stopFleet = (int*)malloc((totalStops + 1) * sizeof(int));
+
+    for (int q = 0; q < numRequests; q++) {
+        int left = requests[q].resourcesNeeded;
+        int cap = (fleetOf[q] == -1) ? left : fleets[fleetOf[q]].maxLoad;
+        while (left > 0) {
+            ConvoyStop* s = &plan->stops[plan->numStops];
+            s->cityId = requests[q].cityId;
+            s->demand = (left < cap) ? left : cap;
+            s->requestIndex = q;
+            stopFleet[plan->numStops] = fleetOf[q];
+            if (fleetOf[q] == -1)
+                plan->unserved[plan->numUnserved++] = plan->numStops;
+            plan->numStops++;
+            left -= s->demand;
+        }
+    }
+
+    // Construction: savings per fleet
+    int* members = (int*)malloc((totalStops + 1) * sizeof(int));
+    for (int f = 0; f < numFleets; f++) {
+        int m = 0;
+        for (int s = 0; s < plan->numStops; s++)
+            if (stopFleet[s] == f) members[m++] = s;
+        if (m > 0) buildFleetRoutes(&w, f, members, m);
+    }
+
+    // Improvement: parallel intra-route moves, then inter-route relocation
+    int improved = 1;
+    while (improved && nowMs() - start < timeBudgetMs) {
+        improved = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(|:improved)
+#endif
+        for (int r = 0; r < plan->numRoutes; r++) {
+            Workspace rw = w;
+            rw.dm = routeTable(&w, r);
+            improved |= twoOpt(&rw, &plan->routes[r]);
+            improved |= orOpt(&rw, &plan->routes[r]);
+        }
+        improved |= relocateBetweenRoutes(&w);
+        plan->improvementPasses++;
+    }
+
+    // Drop emptied routes, compute lengths
+    int kept = 0;
+    for (int r = 0; r < plan->numRoutes; r++) {
+        if (plan->routes[r].numStops == 0) continue;
+        w.dm = routeTable(&w, r);
+        plan->routes[kept] = plan->routes[r];
+        plan->routes[kept].length = routeLength(&w, &plan->routes[kept]);
+        plan->totalDistance += plan->routes[kept].length;
+        kept++;
+    }
+    plan->numRoutes = kept;
+
+    // Hand trips to trucks: heaviest first, to the least-busy truck of the
+    // route's fleet that fits
+    long busy[MAX_TRUCKS] = {0};
+    int trips[MAX_TRUCKS] = {0};
+    for (int pass = 0; pass < plan->numRoutes; pass++) {
+        int r = -1;
+        for (int k = 0; k < plan->numRoutes; k++)
+            if (plan->routes[k].truck == -1 &&
+                (r == -1 || plan->routes[k].load > plan->routes[r].load))
+                r = k;
+        ConvoyRoute* route = &plan->routes[r];
+        int best = -1;
+        for (int t = 0; t < numTrucks; t++)
+            if (trucks[t].depotCity == route->depotCity &&
+                trucks[t].vehicle == route->vehicle &&
+                trucks[t].capacity >= route->load &&
+                (best == -1 || busy[t] < busy[best]))
+                best = t;
+        if (best == -1) {
+            route->truck = CONVOY_NO_TRUCK;
+            continue;
+        }
+        route->truck = best;
+        route->trip = trips[best]++;
+        busy[best] += route->length;
+    }
+
+    // Trips no truck can carry: their stops go unserved
+    kept = 0;
+    for (int r = 0; r < plan->numRoutes; r++) {
+        ConvoyRoute* route = &plan->routes[r];
+        if (route->truck == CONVOY_NO_TRUCK) {
+            for (int k = 0; k < route->numStops; k++)
+                plan->unserved[plan->numUnserved++] = route->stops[k];
+            plan->totalDistance -= route->length;
+            continue;
+        }
+        plan->routes[kept++] = *route;
+    }
+    plan->numRoutes = kept;
+
+    free(members);
+    free(stopFleet);
+    free(fleetOf);
+    free(w.routeCap);
+    free(w.routeMaxLoad);
+    free(w.routeFleet);
+    for (int k = 0; k < numTables; k++) free(tables[k].dm);
+    free(w.row);
+    plan->elapsedMs = nowMs() - start;
+    return plan;
+}
+
+// Build "Depot → A → B → Depot"
+void formatConvoyRoute(Graph* g, const ConvoyPlan* plan,
+                       const ConvoyRoute* r, char* buf, int bufSize) {
+    int len = snprintf(buf, bufSize, "%s", g->cities.name[r->depotCity]);
+    for (int k = 0; k <= r->numStops && len < bufSize; k++) {
+        int c = (k < r->numStops) ? plan->stops[r->stops[k]].cityId : r->depotCity;
+        len += snprintf(buf + len, bufSize - len, " → %s", g->cities.name[c]);
+    }
+}
+
+// Print plan
+void printConvoyPlan(Graph* g, const ConvoyPlan* plan, const Truck trucks[]) {
+    char route[1024];
+    for (int r = 0; r < plan->numRoutes; r++) {
+        const ConvoyRoute* cr = &plan->routes[r];
+        formatConvoyRoute(g, plan, cr, route, sizeof(route));
+        printf("Truck %d (cap %d) trip %d | Load %d | %d km\n",
+               cr->truck + 1, trucks[cr->truck].capacity, cr->trip + 1,
+               cr->load, cr->length);
+        printf("   %s\n", route);
+    }
+    for (int u = 0; u < plan->numUnserved; u++) {
+        const ConvoyStop* s = &plan->stops[plan->unserved[u]];
+        printf("Unserved: %s (%d units)\n", g->cities.name[s->cityId], s->demand);
+    }
+    printf("\nTrips: %d | Total distance: %ld km | Passes: %d | %.2f ms\n",
+           plan->numRoutes, plan->totalDistance, plan->improvementPasses,
+           plan->elapsedMs);
+}
+
+// Free plan
+void freeConvoyPlan(ConvoyPlan* plan) {
+    if (!plan) return;
+    arenaDestroy(&plan->arena);
+    free(plan);
+}
@@ -0,0 +1,62 @@
+// --- FILE: convoy.h ---
+#ifndef CONVOY_H
+#define CONVOY_H
+
+#include "graph.h"
+#include "resources.h"
+#include "allocator.h"
+
+#define MAX_TRUCKS 64
+#define CONVOY_TIME_BUDGET_MS 200.0
+#define CONVOY_NO_TRUCK -2          // Route too heavy for every truck at its depot
+
+// Truck stationed at a depot city
+typedef struct Truck {
+    int depotCity;
+    int capacity;
+    VehicleClass vehicle;   // Decides which restricted roads it may use
+} Truck;
+
+// One delivery (a request, or a capacity-sized piece of one)
+typedef struct ConvoyStop {
+    int cityId;
+    int demand;
+    int requestIndex;
+} ConvoyStop;
+
+// One trip: depot -> stops -> depot
+typedef struct ConvoyRoute {
+    int truck;              // Index into the truck array, -1 until assigned
+    int trip;               // Trip number for that truck (0 = first)
+    int depotCity;
+    VehicleClass vehicle;   // Class of the fleet that runs the trip
+    int numStops;
+    int* stops;             // Indices into plan->stops
+    int load;
+    int length;             // km, including return to depot
+} ConvoyRoute;
+
+// Complete plan; all arrays live in the plan's arena
+typedef struct ConvoyPlan {
+    int numStops;
+    ConvoyStop* stops;
+    int numRoutes;
+    ConvoyRoute* routes;
+    int numUnserved;
+    int* unserved;          // Stop indices no depot can reach or no truck can carry
+    long totalDistance;
+    int improvementPasses;
+    double elapsedMs;
+    Arena arena;
+} ConvoyPlan;
+
+// Planning
+ConvoyPlan* planConvoys(Graph* g, const Truck trucks[], int numTrucks,
+                        const CityRequest requests[], int numRequests,
+                        double timeBudgetMs);
+void formatConvoyRoute(Graph* g, const ConvoyPlan* plan,
+                       const ConvoyRoute* r, char* buf, int bufSize);
+void printConvoyPlan(Graph* g, const ConvoyPlan* plan, const Truck trucks[]);
+void freeConvoyPlan(ConvoyPlan* plan);
+
+#endif // CONVOY_H
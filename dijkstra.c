@@ -1,14 +1,23 @@
 // --- FILE: dijkstra.c ---
 #include "dijkstra.h"
+#include "path.h"
+#include "distcache.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 
 // Create min-heap
 MinHeap* createMinHeap(int capacity) {
-    MinHeap* heap = (MinHeap*)malloc(sizeof(MinHeap));
-    heap->pos = (int*)malloc(capacity * sizeof(int));
-    heap->array = (MinHeapNode**)malloc(capacity * sizeof(MinHeapNode*));
+    // The heap struct lives at the front of its own arena block
+    Arena arena;
+    size_t bytes = sizeof(MinHeap) +
+                   capacity * (sizeof(int) + sizeof(MinHeapNode*) + sizeof(MinHeapNode));
+    arenaInit(&arena, bytes + 4 * ARENA_ALIGN);
+    MinHeap* heap = (MinHeap*)arenaAlloc(&arena, sizeof(MinHeap));
+    heap->arena = arena;
+    heap->pos = (int*)arenaAlloc(&heap->arena, capacity * sizeof(int));
+    heap->array = (MinHeapNode**)arenaAlloc(&heap->arena, capacity * sizeof(MinHeapNode*));
+    heap->nodes = (MinHeapNode*)arenaAlloc(&heap->arena, capacity * sizeof(MinHeapNode));
     heap->size = 0;
     heap->capacity = capacity;
     return heap;
@@ -21,16 +30,16 @@ void swapMinHeapNode(MinHeapNode** a, MinHeapNode** b) {
     *b = temp;
 }
 
-// Heapify at index
+// Heapify at index (HEAP_ARITY children per node)
 void minHeapify(MinHeap* heap, int idx) {
     int smallest = idx;
-    int left = 2 * idx + 1;
-    int right = 2 * idx + 2;
+    int first = HEAP_ARITY * idx + 1;
+    int last = first + HEAP_ARITY;
+    if (last > heap->size) last = heap->size;
 
-    if (left < heap->size && heap->array[left]->distance < heap->array[smallest]->distance)
-        smallest = left;
-    if (right < heap->size && heap->array[right]->distance < heap->array[smallest]->distance)
-        smallest = right;
+    for (int c = first; c < last; c++)
+        if (heap->array[c]->distance < heap->array[smallest]->distance)
+            smallest = c;
 
     if (smallest != idx) {
         MinHeapNode* smallestNode = heap->array[smallest];
@@ -69,11 +78,12 @@ void decreaseKey(MinHeap* heap, int vertex, int distance) {
     int i = heap->pos[vertex];
     heap->array[i]->distance = distance;
 
-    while (i && heap->array[i]->distance < heap->array[(i - 1) / 2]->distance) {
-        heap->pos[heap->array[i]->vertex] = (i - 1) / 2;
-        heap->pos[heap->array[(i - 1) / 2]->vertex] = i;
-        swapMinHeapNode(&heap->array[i], &heap->array[(i - 1) / 2]);
-        i = (i - 1) / 2;
+    while (i && heap->array[i]->distance < heap->array[(i - 1) / HEAP_ARITY]->distance) {
+        int up = (i - 1) / HEAP_ARITY;
+        heap->pos[heap->array[i]->vertex] = up;
+        heap->pos[heap->array[up]->vertex] = i;
+        swapMinHeapNode(&heap->array[i], &heap->array[up]);
+        i = up;
     }
 }
 
@@ -83,9 +93,9 @@ void dijkstra(Graph* g, int source, int dist[], int parent[]) {
     MinHeap* heap = createMinHeap(V);
 
     for (int v = 0; v < V; v++) {
-        dist[v] = INT_MAX;
+        dist[v] = INF;
         parent[v] = -1;
-        heap->array[v] = (MinHeapNode*)malloc(sizeof(MinHeapNode));
+        heap->array[v] = &heap->nodes[v];
         heap->array[v]->vertex = v;
         heap->array[v]->distance = dist[v];
         heap->pos[v] = v;
@@ -98,12 +108,11 @@ void dijkstra(Graph* g, int source, int dist[], int parent[]) {
     while (!isEmpty(heap)) {
         MinHeapNode* minNode = extractMin(heap);
         int u = minNode->vertex;
-        free(minNode);
 
         EdgeNode* edge = g->adjList[u];
         while (edge) {
             int v = edge->destCity;
-            if (dist[u] != INT_MAX && edge->distance + dist[u] < dist[v]) {
+            if (dist[u] != INF && edge->distance < dist[v] - dist[u]) {
                 dist[v] = dist[u] + edge->distance;
                 parent[v] = u;
                 decreaseKey(heap, v, dist[v]);
@@ -115,34 +124,32 @@ void dijkstra(Graph* g, int source, int dist[], int parent[]) {
     freeMinHeap(heap);
 }
 
-// Recursive path print helper
-void printPathRecursive(Graph* g, int parent[], int j) {
-    if (parent[j] == -1) return;
-    printPathRecursive(g, parent, parent[j]);
-    printf(" → %s", g->cities[j].name);
-}
-
 // Print shortest path
 void printShortestPath(Graph* g, int src, int dest, int parent[]) {
     if (parent[dest] == -1 && src != dest) {
-        printf("No path from %s to %s\n", g->cities[src].name, g->cities[dest].name);
+        printf("No path from %s to %s\n", g->cities.name[src], g->cities.name[dest]);
         return;
     }
-    printf(" Route: %s", g->cities[src].name);
-    printPathRecursive(g, parent, dest);
+    int vertices[MAX_CITIES];
+    int len = reconstructPath(parent, NULL, src, dest, vertices, NULL, MAX_CITIES);
+    printf(" Route:");
+    for (int k = 0; k < len; k++)
+        printf("%s%s", k ? " → " : " ", g->cities.name[vertices[k]]);
     printf("\n");
 }
 
-// Shortest distance
+// Shortest distance (roads are bidirectional, so a cached tree
+// from either end answers the query; one hit or miss per query)
 int getShortestDistance(Graph* g, int src, int dest) {
     int dist[MAX_CITIES], parent[MAX_CITIES];
-    dijkstra(g, src, dist, parent);
+    if (probeShortestPaths(g, dest, dist, parent))
+        return dist[src];
+    cachedDijkstra(g, src, dist, parent);
     return dist[dest];
 }
 
 // Free heap
 void freeMinHeap(MinHeap* heap) {
-    free(heap->pos);
-    free(heap->array);
-    free(heap);
+    Arena arena = heap->arena;      // Freed along with the block
+    arenaDestroy(&arena);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #define DIJKSTRA_H
 
 #include "graph.h"
+#include "allocator.h"
 
 // Min-heap node
 typedef struct MinHeapNode {
@@ -16,6 +17,8 @@ typedef struct MinHeap {
     int capacity;
     int* pos;               // Vertex positions in heap
     MinHeapNode** array;
+    MinHeapNode* nodes;     // One node per vertex
+    Arena arena;            // Single block holding the heap and its arrays
 } MinHeap;
 
 // Min-heap functions
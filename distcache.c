@@ -0,0 +1,190 @@
+// --- FILE: distcache.c ---
+#include "distcache.h"
+#include "dijkstra.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#define CACHE_LOCK(c) omp_set_lock(&(c)->lock)
+#define CACHE_UNLOCK(c) omp_unset_lock(&(c)->lock)
+#else
+#define CACHE_LOCK(c) ((void)0)
+#define CACHE_UNLOCK(c) ((void)0)
+#endif
+
+// Create cache
+DistanceCache* createDistanceCache(int capacity) {
+    DistanceCache* cache = (DistanceCache*)malloc(sizeof(DistanceCache));
+    if (!cache) {
+        fprintf(stderr, "Cache memory failed\n");
+        exit(1);
+    }
+    cache->capacity = capacity > 0 ? capacity : DIST_CACHE_CAPACITY;
+    cache->entries = (CacheEntry*)malloc(cache->capacity * sizeof(CacheEntry));
+    if (!cache->entries) {
+        fprintf(stderr, "Cache memory failed\n");
+        exit(1);
+    }
+    cache->hand = 0;
+    for (int i = 0; i < MAX_CITIES; i++) cache->slotOf[i] = -1;
+    for (int i = 0; i < cache->capacity; i++) cache->entries[i].source = -1;
+    memset(&cache->stats, 0, sizeof(CacheStats));
+#ifdef _OPENMP
+    omp_init_lock(&cache->lock);
+#endif
+    return cache;
+}
+
+// Lazily created cache owned by the graph
+DistanceCache* getDistanceCache(Graph* g) {
+    if (!g->distCache)
+        g->distCache = createDistanceCache(DIST_CACHE_CAPACITY);
+    return g->distCache;
+}
+
+// Free cache
+void freeDistanceCache(DistanceCache* cache) {
+    if (!cache) return;
+#ifdef _OPENMP
+    omp_destroy_lock(&cache->lock);
+#endif
+    free(cache->entries);
+    free(cache);
+}
+
+// Would this edit change the tree? Adding a road matters only if it
+// shortens a distance; closing one only if the tree uses it. Cached
+// trees ignore road restrictions, so restricting a road never matters.
+static int editAffects(CacheEntry* e, const GraphEdit* edit) {
+    switch (edit->kind) {
+        case EDIT_ADD_CITY:
+            e->dist[edit->src] = INF;
+            e->parent[edit->src] = -1;
+            return 0;
+        case EDIT_ADD_ROAD: {
+            // Guarded like the relaxations: no sum can pass INF
+            int a = e->dist[edit->src], b = e->dist[edit->dest];
+            return (a != INF && edit->distance < b - a) ||
+                   (b != INF && edit->distance < a - b);
+        }
+        case EDIT_CLOSE_ROAD:
+            return e->parent[edit->dest] == edit->src ||
+                   e->parent[edit->src] == edit->dest;
+        case EDIT_RESTRICT_ROAD:
+            return 0;
+    }
+    return 1;
+}
+
+// Drop a slot
+static void evictSlot(DistanceCache* cache, int slot) {
+    CacheEntry* e = &cache->entries[slot];
+    if (e->source >= 0) cache->slotOf[e->source] = -1;
+    e->source = -1;
+}
+
+// Bring an entry up to the current graph version, or drop it
+static int revalidate(DistanceCache* cache, CacheEntry* e, int slot, const Graph* g) {
+    if (e->version == g->version) return 1;
+
+    for (unsigned int v = e->version + 1; v <= g->version; v++) {
+        const GraphEdit* edit = getGraphEdit(g, v);
+        if (!edit || editAffects(e, edit)) {
+            evictSlot(cache, slot);
+            cache->stats.invalidations++;
+            return 0;
+        }
+    }
+    e->version = g->version;
+    cache->stats.revalidations++;
+    return 1;
+}
+
+// Look up without searching on a miss
+static int lookup(Graph* g, int source, int dist[], int parent[], int countMiss) {
+    DistanceCache* cache = getDistanceCache(g);
+    int found = 0;
+
+    CACHE_LOCK(cache);
+    int slot = cache->slotOf[source];
+    if (slot >= 0) {
+        CacheEntry* e = &cache->entries[slot];
+        if (revalidate(cache, e, slot, g)) {
+            memcpy(dist, e->dist, g->numCities * sizeof(int));
+            memcpy(parent, e->parent, g->numCities * sizeof(int));
+            e->referenced = 1;
+            found = 1;
+        }
+    }
+    if (found) cache->stats.hits++;
+    else if (countMiss) cache->stats.misses++;
+    CACHE_UNLOCK(cache);
+    return found;
+}
+
+int lookupShortestPaths(Graph* g, int source, int dist[], int parent[]) {
+    return lookup(g, source, dist, parent, 1);
+}
+
+// Like lookupShortestPaths, but a miss is not counted: for callers that
+// fall back to another lookup, so each query records one hit or miss
+int probeShortestPaths(Graph* g, int source, int dist[], int parent[]) {
+    return lookup(g, source, dist, parent, 0);
+}
+
+// Full tree, served from the cache when possible
+void cachedDijkstra(Graph* g, int source, int dist[], int parent[]) {
+    if (lookupShortestPaths(g, source, dist, parent)) return;
+
+    // Search outside the lock so other threads keep hitting
+    dijkstra(g, source, dist, parent);
+
+    DistanceCache* cache = g->distCache;
+    CACHE_LOCK(cache);
+    if (cache->slotOf[source] < 0) {
+        // CLOCK: skip recently referenced slots, clearing their bit
+        while (cache->entries[cache->hand].source >= 0 &&
+               cache->entries[cache->hand].referenced) {
+            cache->entries[cache->hand].referenced = 0;
+            cache->hand = (cache->hand + 1) % cache->capacity;
+        }
+        int slot = cache->hand;
+        cache->hand = (cache->hand + 1) % cache->capacity;
+        if (cache->entries[slot].source >= 0) {
+            evictSlot(cache, slot);
+            cache->stats.evictions++;
+        }
+
+        CacheEntry* e = &cache->entries[slot];
+        e->source = source;
+        e->referenced = 1;
+        e->version = g->version;
+        memcpy(e->dist, dist, g->numCities * sizeof(int));
+        memcpy(e->parent, parent, g->numCities * sizeof(int));
+        cache->slotOf[source] = slot;
+    }
+    CACHE_UNLOCK(cache);
+}
+
+// Memory held by the cache
+size_t distanceCacheBytes(const DistanceCache* cache) {
+    return sizeof(DistanceCache) + cache->capacity * sizeof(CacheEntry);
+}
+
+// Print metrics
+void printCacheStats(const DistanceCache* cache) {
+    unsigned long lookups = cache->stats.hits + cache->stats.misses;
+    int used = 0;
+    for (int i = 0; i < cache->capacity; i++)
+        if (cache->entries[i].source >= 0) used++;
+
+    printf("Path cache     | Trees: %d / %d | Memory: %lu B\n",
+           used, cache->capacity, (unsigned long)distanceCacheBytes(cache));
+    printf("%-14s | Hits: %lu | Misses: %lu | Hit rate: %.1f%%\n", "",
+           cache->stats.hits, cache->stats.misses,
+           lookups ? 100.0 * cache->stats.hits / lookups : 0.0);
+    printf("%-14s | Revalidated: %lu | Invalidated: %lu | Evicted: %lu\n", "",
+           cache->stats.revalidations, cache->stats.invalidations,
+           cache->stats.evictions);
+}
@@ -0,0 +1,59 @@
+// --- FILE: distcache.h ---
+#ifndef DISTCACHE_H
+#define DISTCACHE_H
+
+#include "graph.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define DIST_CACHE_CAPACITY 16
+
+// Cached shortest-path tree from one source
+typedef struct CacheEntry {
+    int source;             // -1 = empty slot
+    int referenced;         // CLOCK reference bit
+    unsigned int version;   // Graph version the tree is known valid for
+    int dist[MAX_CITIES];
+    int parent[MAX_CITIES];
+} CacheEntry;
+
+// Cache metrics
+typedef struct CacheStats {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long revalidations;    // Edits replayed without losing the tree
+    unsigned long invalidations;    // Trees dropped because an edit touched them
+    unsigned long evictions;
+} CacheStats;
+
+// Bounded CLOCK cache of shortest-path trees
+typedef struct DistanceCache {
+    int capacity;
+    int hand;
+    int slotOf[MAX_CITIES]; // Source -> slot, -1 if not cached
+    CacheEntry* entries;
+    CacheStats stats;
+#ifdef _OPENMP
+    omp_lock_t lock;
+#endif
+} DistanceCache;
+
+// Cache lifecycle
+DistanceCache* createDistanceCache(int capacity);
+DistanceCache* getDistanceCache(Graph* g);
+void freeDistanceCache(DistanceCache* cache);
+
+// Full shortest-path tree from source (copied into caller buffers)
+void cachedDijkstra(Graph* g, int source, int dist[], int parent[]);
+// Tree from source if cached and still valid; no search on a miss
+int lookupShortestPaths(Graph* g, int source, int dist[], int parent[]);
+// Same, but a miss is left uncounted (caller falls back to another lookup)
+int probeShortestPaths(Graph* g, int source, int dist[], int parent[]);
+
+// Metrics
+size_t distanceCacheBytes(const DistanceCache* cache);
+void printCacheStats(const DistanceCache* cache);
+
+#endif // DISTCACHE_H
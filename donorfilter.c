@@ -0,0 +1,84 @@
+// --- FILE: donorfilter.c ---
+#include "donorfilter.h"
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Count set bits
+static int popCount(unsigned int x) {
+    int n = 0;
+    while (x) {
+        x &= x - 1;
+        n++;
+    }
+    return n;
+}
+
+// Scalar test for a single city
+static int isEligible(const Graph* g, const int dist[],
+                      const DonorCriteria* c, int i) {
+    return g->cities.availableResources[i] >= c->minResources &&
+           g->cities.damageLevel[i] <= c->maxDamage &&
+           (!dist || dist[i] < c->maxDistance);
+}
+
+// Build eligible-donor mask in one pass over the city columns
+int buildDonorMask(const Graph* g, const int dist[],
+                   const DonorCriteria* c, unsigned int mask[]) {
+    int n = g->numCities;
+    int i = 0;
+    memset(mask, 0, CITY_MASK_WORDS * sizeof(unsigned int));
+
+#if defined(__AVX2__)
+    // 8 cities per step; lane groups never straddle a mask word
+    __m256i vMinRes = _mm256_set1_epi32(c->minResources);
+    __m256i vMaxDmg = _mm256_set1_epi32(c->maxDamage);
+    __m256i vMaxDist = _mm256_set1_epi32(c->maxDistance);
+    for (; i + 8 <= n; i += 8) {
+        __m256i res = _mm256_loadu_si256((const __m256i*)&g->cities.availableResources[i]);
+        __m256i dmg = _mm256_loadu_si256((const __m256i*)&g->cities.damageLevel[i]);
+        __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi32(vMinRes, res),
+                                      _mm256_cmpgt_epi32(dmg, vMaxDmg));
+        unsigned int bits = ~(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(bad)) & 0xFFu;
+        if (dist) {
+            __m256i d = _mm256_loadu_si256((const __m256i*)&dist[i]);
+            __m256i ok = _mm256_cmpgt_epi32(vMaxDist, d);
+            bits &= (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(ok));
+        }
+        mask[i >> 5] |= bits << (i & 31);
+    }
+#elif defined(__SSE2__)
+    // 4 cities per step
+    __m128i vMinRes = _mm_set1_epi32(c->minResources);
+    __m128i vMaxDmg = _mm_set1_epi32(c->maxDamage);
+    __m128i vMaxDist = _mm_set1_epi32(c->maxDistance);
+    for (; i + 4 <= n; i += 4) {
+        __m128i res = _mm_loadu_si128((const __m128i*)&g->cities.availableResources[i]);
+        __m128i dmg = _mm_loadu_si128((const __m128i*)&g->cities.damageLevel[i]);
+        __m128i bad = _mm_or_si128(_mm_cmpgt_epi32(vMinRes, res),
+                                   _mm_cmpgt_epi32(dmg, vMaxDmg));
+        unsigned int bits = ~(unsigned int)_mm_movemask_ps(_mm_castsi128_ps(bad)) & 0xFu;
+        if (dist) {
+            __m128i d = _mm_loadu_si128((const __m128i*)&dist[i]);
+            __m128i ok = _mm_cmpgt_epi32(vMaxDist, d);
+            bits &= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(ok));
+        }
+        mask[i >> 5] |= bits << (i & 31);
+    }
+#endif
+
+    // Scalar tail (or whole range without SIMD)
+    for (; i < n; i++)
+        if (isEligible(g, dist, c, i))
+            CITY_MASK_SET(mask, i);
+
+    if (c->excludeCity >= 0 && c->excludeCity < n)
+        CITY_MASK_CLEAR(mask, c->excludeCity);
+
+    int count = 0;
+    for (int w = 0; w < (n + 31) / 32; w++)
+        count += popCount(mask[w]);
+    return count;
+}
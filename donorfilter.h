@@ -0,0 +1,20 @@
+// --- FILE: donorfilter.h ---
+#ifndef DONORFILTER_H
+#define DONORFILTER_H
+
+#include "graph.h"
+
+// Donor eligibility test applied to every city column at once
+typedef struct DonorCriteria {
+    int minResources;       // availableResources >= minResources
+    int maxDamage;          // damageLevel <= maxDamage
+    int maxDistance;        // dist < maxDistance (ignored when dist is NULL)
+    int excludeCity;        // Never eligible (the disaster city), -1 for none
+} DonorCriteria;
+
+// Fill mask with one bit per eligible city; returns the eligible count.
+// Uses AVX2 or SSE2 when the compiler targets them, scalar otherwise.
+int buildDonorMask(const Graph* g, const int dist[],
+                   const DonorCriteria* c, unsigned int mask[]);
+
+#endif // DONORFILTER_H
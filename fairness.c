@@ -0,0 +1,261 @@
+// --- FILE: fairness.c ---
+#include "fairness.h"
+#include "donorfilter.h"
+#include "connectivity.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// People affected, scaled by damage; never zero so every request counts
+double cityWeight(const Graph* g, int city) {
+    double people = g->cities.population[city] > 0 ? g->cities.population[city] : 1;
+    return people * (g->cities.damageLevel[city] + 1);
+}
+
+// --- Water-Filling Solver ---
+// Request ordered by the level at which it becomes fully served
+typedef struct FillItem {
+    double level;           // need / weight
+    double fraction;        // Rounding remainder of the unsaturated share
+    int idx;
+} FillItem;
+
+static int compareLevel(const void* a, const void* b) {
+    const FillItem* x = (const FillItem*)a;
+    const FillItem* y = (const FillItem*)b;
+    if (x->level != y->level) return x->level < y->level ? -1 : 1;
+    return x->idx - y->idx;
+}
+
+static int compareFraction(const void* a, const void* b) {
+    const FillItem* x = (const FillItem*)a;
+    const FillItem* y = (const FillItem*)b;
+    if (x->fraction != y->fraction) return x->fraction > y->fraction ? -1 : 1;
+    return x->idx - y->idx;
+}
+
+// Weighted max-min split of one component's stock. Requests are filled
+// in order of need/weight; once the rest can no longer all be filled,
+// each remaining request gets level x weight, rounded down, and the
+// leftover units go to the largest remainders.
+static long fillComponent(const CityRequest reqs[], const double weight[],
+                          FillItem* items, int count, long stock, int share[]) {
+    for (int k = 0; k < count; k++) {
+        int i = items[k].idx;
+        items[k].level = reqs[i].resourcesNeeded / weight[i];
+    }
+    qsort(items, count, sizeof(FillItem), compareLevel);
+
+    double restWeight = 0.0;
+    for (int k = 0; k < count; k++) restWeight += weight[items[k].idx];
+
+    long left = stock;
+    int k = 0;
+    for (; k < count; k++) {
+        int i = items[k].idx;
+        if (reqs[i].resourcesNeeded > left * (weight[i] / restWeight)) break;
+        share[i] = reqs[i].resourcesNeeded;
+        left -= share[i];
+        restWeight -= weight[i];
+    }
+    if (k == count) return stock - left;
+
+    double level = left / restWeight;
+    long given = 0;
+    for (int m = k; m < count; m++) {
+        int i = items[m].idx;
+        double exact = level * weight[i];
+        share[i] = (int)exact;
+        if (share[i] > reqs[i].resourcesNeeded) share[i] = reqs[i].resourcesNeeded;
+        items[m].fraction = exact - share[i];
+        given += share[i];
+    }
+    left -= given;
+
+    qsort(items + k, count - k, sizeof(FillItem), compareFraction);
+    for (int m = k; m < count && left > 0; m++) {
+        int i = items[m].idx;
+        if (share[i] < reqs[i].resourcesNeeded) {
+            share[i]++;
+            left--;
+        }
+    }
+    return stock - left;
+}
+
+// Split donor stock between requests: each connected component's stock
+// goes only to requests in that component. Returns units granted.
+long solveFairShares(Graph* g, const CityRequest reqs[], int n, const double weight[],
+                     const unsigned int donors[], int share[]) {
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    long stock[MAX_CITIES] = {0};
+    for (int i = 0; i < g->numCities; i++)
+        if (CITY_MASK_TEST(donors, i))
+            stock[idx->component[i]] += g->cities.availableResources[i];
+
+    FillItem* items = (FillItem*)malloc((n > 0 ? n : 1) * sizeof(FillItem));
+    if (!items) {
+        fprintf(stderr, "Fair share memory failed\n");
+        exit(1);
+    }
+
+    long granted = 0;
+    unsigned int done[CITY_MASK_WORDS] = {0};   // Components already solved
+    for (int r = 0; r < n; r++) {
+        int comp = idx->component[reqs[r].cityId];
+        if (CITY_MASK_TEST(done, comp)) continue;
+        CITY_MASK_SET(done, comp);
+
+        int count = 0;
+        for (int q = r; q < n; q++)
+            if (idx->component[reqs[q].cityId] == comp)
+                items[count++].idx = q;
+        granted += fillComponent(reqs, weight, items, count, stock[comp], share);
+    }
+    free(items);
+    return granted;
+}
+
+// --- Batch Allocation ---
+static int compareWeightDesc(const void* a, const void* b) {
+    const FillItem* x = (const FillItem*)a;
+    const FillItem* y = (const FillItem*)b;
+    if (x->level != y->level) return x->level > y->level ? -1 : 1;
+    return x->idx - y->idx;
+}
+
+// Drain the queue, solve the split, then send each share from the
+// nearest donors outside the batch (heaviest request first). No I/O.
+FairBatch* allocateFairBatch(Graph* g, PriorityQueue* pq) {
+    FairBatch* b = (FairBatch*)calloc(1, sizeof(FairBatch));
+    if (!b) {
+        fprintf(stderr, "Fair batch memory failed\n");
+        exit(1);
+    }
+    while (!isPQEmpty(pq))
+        b->requests[b->numRequests++] = extractMostUrgent(pq);
+    int n = b->numRequests;
+
+    // Cities in the batch receive; they do not donate
+    unsigned int inBatch[CITY_MASK_WORDS] = {0};
+    int perCity[MAX_CITIES] = {0};
+    for (int r = 0; r < n; r++) {
+        CITY_MASK_SET(inBatch, b->requests[r].cityId);
+        perCity[b->requests[r].cityId]++;
+        b->demand += b->requests[r].resourcesNeeded;
+    }
+    for (int r = 0; r < n; r++) {
+        int c = b->requests[r].cityId;
+        b->weight[r] = cityWeight(g, c) / perCity[c];
+    }
+
+    unsigned int donors[CITY_MASK_WORDS];
+    DonorCriteria crit = { 1, 6, INF, -1 };
+    buildDonorMask(g, NULL, &crit, donors);
+    for (int w = 0; w < CITY_MASK_WORDS; w++)
+        donors[w] &= ~inBatch[w];
+
+    double start = nowMs();
+    b->granted = solveFairShares(g, b->requests, n, b->weight, donors, b->share);
+    b->solveMs = nowMs() - start;
+
+    // Stock that some request could reach
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    unsigned int wanted[CITY_MASK_WORDS] = {0};
+    for (int r = 0; r < n; r++)
+        CITY_MASK_SET(wanted, idx->component[b->requests[r].cityId]);
+    for (int i = 0; i < g->numCities; i++)
+        if (CITY_MASK_TEST(donors, i) && CITY_MASK_TEST(wanted, idx->component[i]))
+            b->supply += g->cities.availableResources[i];
+
+    // level holds the weight here
+    FillItem* order = (FillItem*)malloc((n > 0 ? n : 1) * sizeof(FillItem));
+    if (!order) {
+        fprintf(stderr, "Fair batch memory failed\n");
+        exit(1);
+    }
+    for (int r = 0; r < n; r++) {
+        order[r].level = b->weight[r];
+        order[r].idx = r;
+    }
+    qsort(order, n, sizeof(FillItem), compareWeightDesc);
+
+    start = nowMs();
+    int dist[MAX_CITIES], parent[MAX_CITIES];
+    AllocationResult res;
+    for (int k = 0; k < n; k++) {
+        int r = order[k].idx;
+        allocateFromDonors(g, b->requests[r].cityId, b->share[r], inBatch,
+                           dist, parent, &res);
+        b->sent[r] = res.total;
+        b->farthest[r] = res.farthest;
+        b->support[r] = res.numDonors == 0 ? FAIR_SUPPORT_NONE
+                      : res.numDonors == 1 ? res.donorIds[0]
+                      : FAIR_SUPPORT_MULTIPLE;
+    }
+    b->dispatchMs = nowMs() - start;
+    free(order);
+    return b;
+}
+
+static const char* supportName(const Graph* g, int support) {
+    if (support == FAIR_SUPPORT_NONE) return "N/A";
+    if (support == FAIR_SUPPORT_MULTIPLE) return "Multiple";
+    return g->cities.name[support];
+}
+
+void printFairBatch(const Graph* g, const FairBatch* b) {
+    printf("Requests: %d | Demand: %ld | Reachable stock: %ld | Granted: %ld\n",
+           b->numRequests, b->demand, b->supply, b->granted);
+    printf("Solve: %.3f ms | Dispatch: %.3f ms\n\n", b->solveMs, b->dispatchMs);
+
+    printf("  %-15s | %12s | %6s | %6s | %5s | %-12s\n",
+           "City", "Weight", "Need", "Sent", "Fill", "Support");
+    int worst = -1;
+    for (int r = 0; r < b->numRequests; r++) {
+        const CityRequest* q = &b->requests[r];
+        double fill = q->resourcesNeeded > 0
+                      ? 100.0 * b->sent[r] / q->resourcesNeeded : 100.0;
+        printf("  %-15s | %12.0f | %6d | %6d | %4.0f%% | %-12s\n",
+               q->cityName, b->weight[r], q->resourcesNeeded, b->sent[r],
+               fill, supportName(g, b->support[r]));
+        if (worst < 0 || b->sent[r] * (double)b->requests[worst].resourcesNeeded <
+                         b->sent[worst] * (double)q->resourcesNeeded)
+            worst = r;
+    }
+    if (worst >= 0 && b->granted < b->demand)
+        printf("\nLowest fill: %s (%d of %d units)\n",
+               b->requests[worst].cityName, b->sent[worst],
+               b->requests[worst].resourcesNeeded);
+}
+
+// Fair split of every pending request, recorded like allocateResources
+void allocateResourcesFairly(Graph* g, PriorityQueue* pq, HashMap* map) {
+    if (isPQEmpty(pq)) {
+        printf("\nNo pending requests.\n");
+        return;
+    }
+
+    FairBatch* b = allocateFairBatch(g, pq);
+    printFairBatch(g, b);
+
+    char note[64];
+    for (int r = 0; r < b->numRequests; r++) {
+        const CityRequest* q = &b->requests[r];
+        const char* support = supportName(g, b->support[r]);
+        if (b->sent[r] < q->resourcesNeeded) {
+            insertHashEntry(map, q->cityId, q->cityName, FAILED, b->sent[r],
+                            DONOR_NONE, b->sent[r] > 0 ? "Partial" : "N/A",
+                            b->farthest[r]);
+        } else {
+            insertHashEntry(map, q->cityId, q->cityName, IN_TRANSIT, b->sent[r],
+                            b->support[r], support, b->farthest[r]);
+        }
+        snprintf(note, sizeof(note), "Fair batch share (%d of %d requested)",
+                 b->sent[r], q->resourcesNeeded);
+        logAllocation(q->cityName, support, b->sent[r], b->farthest[r], note);
+    }
+    free(b);
+    printf("\nBatch logged to file.\n");
+}
@@ -0,0 +1,37 @@
+// --- FILE: fairness.h ---
+#ifndef FAIRNESS_H
+#define FAIRNESS_H
+
+#include "graph.h"
+#include "resources.h"
+
+#define FAIR_SUPPORT_NONE DONOR_NONE
+#define FAIR_SUPPORT_MULTIPLE DONOR_MULTIPLE
+
+// One batch of competing requests and the split chosen for it
+typedef struct FairBatch {
+    int numRequests;
+    CityRequest requests[MAX_REQUESTS];
+    double weight[MAX_REQUESTS];    // Population x (damage + 1), split between a city's requests
+    int share[MAX_REQUESTS];        // Units granted by the solver
+    int sent[MAX_REQUESTS];         // Units dispatched
+    int support[MAX_REQUESTS];      // Donor city, or FAIR_SUPPORT_*
+    int farthest[MAX_REQUESTS];     // km to the farthest donor used
+    long demand;
+    long supply;                    // Donor stock reachable by some request
+    long granted;
+    double solveMs;
+    double dispatchMs;
+} FairBatch;
+
+// Solver (no I/O, no stock changes)
+double cityWeight(const Graph* g, int city);
+long solveFairShares(Graph* g, const CityRequest reqs[], int n, const double weight[],
+                     const unsigned int donors[], int share[]);
+
+// Batch allocation
+FairBatch* allocateFairBatch(Graph* g, PriorityQueue* pq);
+void printFairBatch(const Graph* g, const FairBatch* b);
+void allocateResourcesFairly(Graph* g, PriorityQueue* pq, HashMap* map);
+
+#endif // FAIRNESS_H
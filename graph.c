@@ -1,5 +1,9 @@
 // --- FILE: graph.c ---
 #include "graph.h"
+#include "spatial.h"
+#include "distcache.h"
+#include "connectivity.h"
+#include "partition.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,11 +16,75 @@ Graph* createGraph(int n) {
         exit(1);
     }
     g->numCities = 0;
+    g->spatialIndex = NULL;
+    g->distCache = NULL;
+    g->connectivity = NULL;
+    g->regions = NULL;
+    g->inventory = NULL;
+    g->version = 0;
+    g->numProfiles = 0;
+    g->numProfilePoints = 0;
+    poolInit(&g->edgePool, sizeof(EdgeNode), EDGES_PER_CHUNK);
+    memset(g->sharedLists, 0, sizeof(g->sharedLists));
     for (int i = 0; i < MAX_CITIES; i++)
         g->adjList[i] = NULL;
     return g;
 }
 
+// Copy-on-write view: cities and profiles are copied, adjacency lists are
+// shared with the base until the view edits them. The base must not be
+// edited or freed while views of it exist.
+Graph* createGraphView(const Graph* base) {
+    Graph* g = (Graph*)malloc(sizeof(Graph));
+    if (!g) {
+        fprintf(stderr, "Graph memory failed\n");
+        exit(1);
+    }
+    memcpy(g, base, sizeof(Graph));
+    poolInit(&g->edgePool, sizeof(EdgeNode), EDGES_PER_CHUNK);
+    g->spatialIndex = NULL;
+    g->distCache = NULL;
+    g->connectivity = NULL;
+    g->regions = NULL;
+    g->inventory = NULL;        // Views work on a snapshot of the stock column
+    for (int i = 0; i < g->numCities; i++)
+        if (g->adjList[i])
+            CITY_MASK_SET(g->sharedLists, i);
+    return g;
+}
+
+// Give a view its own copy of a shared adjacency list before mutating it
+static void ownList(Graph* g, int city) {
+    if (!CITY_MASK_TEST(g->sharedLists, city)) return;
+    EdgeNode** link = &g->adjList[city];
+    for (const EdgeNode* e = g->adjList[city]; e; e = e->next) {
+        EdgeNode* copy = (EdgeNode*)poolAlloc(&g->edgePool);
+        *copy = *e;
+        *link = copy;
+        link = &copy->next;
+    }
+    *link = NULL;
+    CITY_MASK_CLEAR(g->sharedLists, city);
+}
+
+// Append to the edit log and bump the version
+static void recordEdit(Graph* g, EditKind kind, int src, int dest, int distance) {
+    g->version++;
+    GraphEdit* e = &g->editLog[g->version % EDIT_LOG_SIZE];
+    e->kind = kind;
+    e->src = src;
+    e->dest = dest;
+    e->distance = distance;
+}
+
+// Edit that produced a version (NULL once it has left the log)
+const GraphEdit* getGraphEdit(const Graph* g, unsigned int version) {
+    if (version == 0 || version > g->version ||
+        g->version - version >= EDIT_LOG_SIZE)
+        return NULL;
+    return &g->editLog[version % EDIT_LOG_SIZE];
+}
+
 // Add city
 void addCity(Graph* g, int id, const char* name, int population,
              int damageLevel, int resources, double lat, double lon) {
@@ -25,16 +93,18 @@ void addCity(Graph* g, int id, const char* name, int population,
         return;
     }
 
-    City* city = &g->cities[g->numCities];
-    city->id = id;
-    strncpy(city->name, name, MAX_NAME_LEN - 1);
-    city->name[MAX_NAME_LEN - 1] = '\0';
-    city->population = population;
-    city->damageLevel = damageLevel;
-    city->availableResources = resources;
-    city->latitude = lat;
-    city->longitude = lon;
+    CityTable* c = &g->cities;
+    int i = g->numCities;
+    c->id[i] = id;
+    strncpy(c->name[i], name, MAX_NAME_LEN - 1);
+    c->name[i][MAX_NAME_LEN - 1] = '\0';
+    c->population[i] = population;
+    c->damageLevel[i] = damageLevel;
+    c->availableResources[i] = resources;
+    c->latitude[i] = lat;
+    c->longitude[i] = lon;
     g->numCities++;
+    recordEdit(g, EDIT_ADD_CITY, i, i, 0);
 }
 
 // Add edge (bidirectional)
@@ -44,25 +114,102 @@ void addEdge(Graph* g, int src, int dest, int distance) {
         return;
     }
 
-    EdgeNode* newNode = (EdgeNode*)malloc(sizeof(EdgeNode));
-    if (!newNode) {
-        fprintf(stderr, "Edge memory failed\n");
-        return;
-    }
+    EdgeNode* newNode = (EdgeNode*)poolAlloc(&g->edgePool);
     newNode->destCity = dest;
     newNode->distance = distance;
+    newNode->maxLoad = 0;
+    newNode->profile = -1;
+    newNode->vehicleMask = ALL_VEHICLES;
     newNode->next = g->adjList[src];
     g->adjList[src] = newNode;
 
-    newNode = (EdgeNode*)malloc(sizeof(EdgeNode));
-    if (!newNode) {
-        fprintf(stderr, "Edge memory failed\n");
-        return;
-    }
+    newNode = (EdgeNode*)poolAlloc(&g->edgePool);
     newNode->destCity = src;
     newNode->distance = distance;
+    newNode->maxLoad = 0;
+    newNode->profile = -1;
+    newNode->vehicleMask = ALL_VEHICLES;
     newNode->next = g->adjList[dest];
     g->adjList[dest] = newNode;
+    recordEdit(g, EDIT_ADD_ROAD, src, dest, distance);
+}
+
+// Remove every edge between two cities (both directions).
+// Returns the number of edges removed.
+int closeRoad(Graph* g, int src, int dest) {
+    if (src >= g->numCities || dest >= g->numCities || src < 0 || dest < 0) {
+        fprintf(stderr, "Invalid city index\n");
+        return 0;
+    }
+
+    int removed = 0;
+    for (int side = 0; side < 2; side++) {
+        int from = side ? dest : src, to = side ? src : dest;
+        ownList(g, from);
+        EdgeNode** link = &g->adjList[from];
+        while (*link) {
+            if ((*link)->destCity == to) {
+                EdgeNode* dead = *link;
+                *link = dead->next;
+                poolFree(&g->edgePool, dead);
+                removed++;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+    if (removed > 0)
+        recordEdit(g, EDIT_CLOSE_ROAD, src, dest, 0);
+    return removed;
+}
+
+// Set travel-time profile and load/vehicle limits on both directions of a road.
+// Returns the number of edges updated (0 if the road does not exist).
+int setRoadRestrictions(Graph* g, int src, int dest, int profile,
+                        int maxLoad, unsigned int vehicleMask) {
+    if (src >= g->numCities || dest >= g->numCities || src < 0 || dest < 0 ||
+        profile >= g->numProfiles) {
+        fprintf(stderr, "Invalid road restriction\n");
+        return 0;
+    }
+
+    int updated = 0;
+    for (int side = 0; side < 2; side++) {
+        int from = side ? dest : src, to = side ? src : dest;
+        ownList(g, from);
+        for (EdgeNode* e = g->adjList[from]; e; e = e->next) {
+            if (e->destCity != to) continue;
+            e->profile = (short)profile;
+            e->maxLoad = maxLoad;
+            e->vehicleMask = (unsigned char)vehicleMask;
+            updated++;
+        }
+    }
+    if (updated > 0)
+        recordEdit(g, EDIT_RESTRICT_ROAD, src, dest, 0);
+    return updated;
+}
+
+// Undirected roads as (src < dest) pairs, parallel edges merged.
+// Arrays must hold MAX_ROADS entries, or as many as a first call with
+// NULL arrays reports. Returns the number of roads.
+int collectRoads(const Graph* g, int src[], int dest[]) {
+    unsigned int seen[CITY_MASK_WORDS];
+    int count = 0;
+    for (int u = 0; u < g->numCities; u++) {
+        memset(seen, 0, sizeof(seen));
+        for (const EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            int v = e->destCity;
+            if (v <= u || CITY_MASK_TEST(seen, v)) continue;
+            CITY_MASK_SET(seen, v);
+            if (src) {
+                src[count] = u;
+                dest[count] = v;
+            }
+            count++;
+        }
+    }
+    return count;
 }
 
 // Display graph
@@ -72,11 +219,11 @@ void displayGraph(Graph* g) {
     printf("---------------------------------------------------------------------\n\n");
     
     for (int i = 0; i < g->numCities; i++) {
-        City* city = &g->cities[i];
-        printf("  City: %-15s [ID: %d]\n", city->name, city->id);
+        CityTable* c = &g->cities;
+        printf("  City: %-15s [ID: %d]\n", c->name[i], c->id[i]);
         printf("   Population: %d | Damage Level: %d/10 | Resources: %d units\n",
-               city->population, city->damageLevel, city->availableResources);
-        printf("   Coordinates: (%.2f, %.2f)\n", city->latitude, city->longitude);
+               c->population[i], c->damageLevel[i], c->availableResources[i]);
+        printf("   Coordinates: (%.2f, %.2f)\n", c->latitude[i], c->longitude[i]);
         printf("   Connected to: ");
         
         EdgeNode* edge = g->adjList[i];
@@ -84,7 +231,11 @@ void displayGraph(Graph* g) {
             printf("None\n");
         } else {
             while (edge) {
-                printf("%s (%d km)", g->cities[edge->destCity].name, edge->distance);
+                printf("%s (%d km", g->cities.name[edge->destCity], edge->distance);
+                if (edge->profile >= 0) printf(", timed");
+                if (edge->maxLoad > 0) printf(", max %d", edge->maxLoad);
+                if (edge->vehicleMask != ALL_VEHICLES) printf(", restricted");
+                printf(")");
                 edge = edge->next;
                 if (edge) printf(", ");
             }
@@ -97,21 +248,18 @@ void displayGraph(Graph* g) {
 // Find city index
 int findCityByName(Graph* g, const char* name) {
     for (int i = 0; i < g->numCities; i++) {
-        if (strcmp(g->cities[i].name, name) == 0)
+        if (strcmp(g->cities.name[i], name) == 0)
             return i;
     }
     return -1;
 }
 
-// Free memory
+// Free memory (edges go with their pool in one step)
 void freeGraph(Graph* g) {
-    for (int i = 0; i < g->numCities; i++) {
-        EdgeNode* current = g->adjList[i];
-        while (current) {
-            EdgeNode* temp = current;
-            current = current->next;
-            free(temp);
-        }
-    }
+    poolDestroy(&g->edgePool);
+    freeSpatialIndex(g->spatialIndex);
+    freeDistanceCache(g->distCache);
+    freeConnectivityIndex(g->connectivity);
+    freeRegionOverlay(g->regions);
     free(g);
 }
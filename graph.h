@@ -2,40 +2,116 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
-#define INF 999999
-#define MAX_CITIES 50
+#include "config.h"
+#include "allocator.h"
+#include <limits.h>
+
+#define INF INT_MAX             // Unreachable; relaxations stay strictly below it
+#define MAX_ROADS (MAX_CITIES * (MAX_CITIES - 1) / 2)
 #define MAX_NAME_LEN 50
+#define EDGES_PER_CHUNK 256
+#define MAX_PROFILES 64
+#define MAX_PROFILE_POINTS 1024
+#define EDIT_LOG_SIZE 64
+
+// Vehicle classes allowed on a road (bit per class)
+typedef enum {
+    VEHICLE_LIGHT,
+    VEHICLE_TRUCK,
+    VEHICLE_HEAVY
+} VehicleClass;
+
+#define VEHICLE_BIT(v) (1u << (v))
+#define ALL_VEHICLES (VEHICLE_BIT(VEHICLE_LIGHT) | VEHICLE_BIT(VEHICLE_TRUCK) | \
+                      VEHICLE_BIT(VEHICLE_HEAVY))
 
-// City info
-typedef struct City {
-    int id;
-    char name[MAX_NAME_LEN];
-    int population;
-    int damageLevel;
-    int availableResources;
-    double latitude;
-    double longitude;
-} City;
+// City bitmask (one bit per city id)
+#define CITY_MASK_WORDS ((MAX_CITIES + 31) / 32)
+#define CITY_MASK_TEST(m, i) (((m)[(i) >> 5] >> ((i) & 31)) & 1u)
+#define CITY_MASK_SET(m, i) ((m)[(i) >> 5] |= 1u << ((i) & 31))
+#define CITY_MASK_CLEAR(m, i) ((m)[(i) >> 5] &= ~(1u << ((i) & 31)))
+
+// City attributes stored column-wise (one array per field) so donor
+// filters stream only the columns they test; names live in a side table
+typedef struct CityTable {
+    int id[MAX_CITIES];
+    int population[MAX_CITIES];
+    int damageLevel[MAX_CITIES];
+    int availableResources[MAX_CITIES];
+    double latitude[MAX_CITIES];
+    double longitude[MAX_CITIES];
+    char name[MAX_CITIES][MAX_NAME_LEN];
+} CityTable;
 
 // Edge node
 typedef struct EdgeNode {
     int destCity;
     int distance;
+    int maxLoad;                // Units the road can carry, 0 = unlimited
+    short profile;              // Travel-time profile, -1 = free-flow speed
+    unsigned char vehicleMask;  // Allowed VehicleClass bits
     struct EdgeNode* next;
 } EdgeNode;
 
+// Breakpoint of a piecewise-linear travel-time profile
+typedef struct ProfilePoint {
+    short minuteOfDay;          // 0-1439, strictly increasing within a profile
+    short travelMinutes;
+} ProfilePoint;
+
+// Profile = slice of Graph.profilePoints
+typedef struct TravelProfile {
+    short first;
+    short count;
+} TravelProfile;
+
+// Structural edit, kept so caches can replay what changed since
+// they were built instead of flushing on every version bump
+typedef enum {
+    EDIT_ADD_CITY,
+    EDIT_ADD_ROAD,
+    EDIT_CLOSE_ROAD,
+    EDIT_RESTRICT_ROAD      // Profile, load or vehicle limits changed
+} EditKind;
+
+typedef struct GraphEdit {
+    EditKind kind;
+    int src;
+    int dest;
+    int distance;
+} GraphEdit;
+
 // Graph
 typedef struct Graph {
     int numCities;
-    City cities[MAX_CITIES];
+    CityTable cities;
     EdgeNode* adjList[MAX_CITIES];
+    Pool edgePool;                      // Backing store for all EdgeNodes
+    int numProfiles;
+    int numProfilePoints;
+    TravelProfile profiles[MAX_PROFILES];
+    ProfilePoint profilePoints[MAX_PROFILE_POINTS];
+    struct SpatialIndex* spatialIndex;  // Built lazily, see getSpatialIndex
+    struct DistanceCache* distCache;    // Built lazily, see getDistanceCache
+    struct ConnectivityIndex* connectivity; // Built lazily, see getConnectivityIndex
+    struct RegionOverlay* regions;      // Built lazily, see getRegionOverlay
+    struct Inventory* inventory;        // Stock ledger (caller-owned), see attachInventory
+    unsigned int version;               // Bumped on every structural edit
+    GraphEdit editLog[EDIT_LOG_SIZE];   // Edit for version v at v % EDIT_LOG_SIZE
+    unsigned int sharedLists[CITY_MASK_WORDS]; // Views: lists still owned by the base
 } Graph;
 
 // Functions
 Graph* createGraph(int n);
+Graph* createGraphView(const Graph* base);
 void addCity(Graph* g, int id, const char* name, int population,
              int damageLevel, int resources, double lat, double lon);
 void addEdge(Graph* g, int src, int dest, int distance);
+int closeRoad(Graph* g, int src, int dest);
+const GraphEdit* getGraphEdit(const Graph* g, unsigned int version);
+int setRoadRestrictions(Graph* g, int src, int dest, int profile,
+                        int maxLoad, unsigned int vehicleMask);
+int collectRoads(const Graph* g, int src[], int dest[]);
 void displayGraph(Graph* g);
 void freeGraph(Graph* g);
 int findCityByName(Graph* g, const char* name);
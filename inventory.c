@@ -0,0 +1,368 @@
+// --- FILE: inventory.c ---
+#include "inventory.h"
+#include "donorfilter.h"
+#include "distcache.h"
+#include "connectivity.h"
+#include "timeroute.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Create an empty ledger (every cell zero, no commodities)
+Inventory* createInventory(void) {
+    Inventory* inv = (Inventory*)calloc(1, sizeof(Inventory));
+    size_t cells = (size_t)MAX_CITIES * MAX_COMMODITIES;
+    if (inv) {
+        inv->onHand = (int*)calloc(cells, sizeof(int));
+        inv->reserved = (int*)calloc(cells, sizeof(int));
+        inv->incoming = (int*)calloc(cells, sizeof(int));
+        inv->shipments = (Shipment*)malloc(SHIPMENTS_INITIAL * sizeof(Shipment));
+    }
+    if (!inv || !inv->onHand || !inv->reserved || !inv->incoming || !inv->shipments) {
+        fprintf(stderr, "Inventory memory failed\n");
+        exit(1);
+    }
+    inv->capacity = SHIPMENTS_INITIAL;
+    return inv;
+}
+
+void freeInventory(Inventory* inv) {
+    if (!inv) return;
+    free(inv->onHand);
+    free(inv->reserved);
+    free(inv->incoming);
+    free(inv->shipments);
+    free(inv);
+}
+
+// Every change to a cell's available units goes through here, so the
+// per-commodity totals and the graph's per-city column stay exact
+static void adjustAvailable(Inventory* inv, int city, int commodity, int delta) {
+    inv->totalAvailable[commodity] += delta;
+    if (inv->cityAvailable) inv->cityAvailable[city] += delta;
+}
+
+// Register a commodity; returns its index, or -1 when the table is full
+int addCommodity(Inventory* inv, const char* name) {
+    int c = findCommodity(inv, name);
+    if (c >= 0) return c;
+    if (inv->numCommodities == MAX_COMMODITIES) return -1;
+    c = inv->numCommodities++;
+    strncpy(inv->commodity[c], name, MAX_NAME_LEN - 1);
+    inv->commodity[c][MAX_NAME_LEN - 1] = '\0';
+    return c;
+}
+
+int findCommodity(const Inventory* inv, const char* name) {
+    for (int c = 0; c < inv->numCommodities; c++)
+        if (strcmp(inv->commodity[c], name) == 0)
+            return c;
+    return -1;
+}
+
+// Set the units on hand (stock counts, not a shipment); reservations stay
+void setStock(Inventory* inv, int city, int commodity, int units) {
+    int cell = STOCK_CELL(city, commodity);
+    if (units < inv->reserved[cell]) units = inv->reserved[cell];
+    adjustAvailable(inv, city, commodity, units - inv->onHand[cell]);
+    inv->onHand[cell] = units;
+}
+
+int availableStock(const Inventory* inv, int city, int commodity) {
+    int cell = STOCK_CELL(city, commodity);
+    return inv->onHand[cell] - inv->reserved[cell];
+}
+
+void attachInventory(Graph* g, Inventory* inv) {
+    g->inventory = inv;
+    inv->cityAvailable = g->cities.availableResources;
+    for (int i = 0; i < g->numCities; i++) {
+        int units = 0;
+        for (int c = 0; c < inv->numCommodities; c++)
+            units += availableStock(inv, i, c);
+        inv->cityAvailable[i] = units;
+    }
+}
+
+// Ship units of a donor's unreserved stock to a city as a mixed load,
+// each commodity in proportion to what the donor holds. Returns the units
+// shipped (less than asked only if the donor runs out).
+int drawStock(Inventory* inv, int donor, int to, int units, int distance) {
+    int take[MAX_COMMODITIES];
+    long total = 0;
+    for (int c = 0; c < inv->numCommodities; c++)
+        total += availableStock(inv, donor, c);
+    if (units > total) units = (int)total;
+    if (units <= 0) return 0;
+
+    int left = units;
+    for (int c = 0; c < inv->numCommodities; c++) {
+        take[c] = (int)((long)units * availableStock(inv, donor, c) / total);
+        left -= take[c];
+    }
+    // Rounding remainder from the first commodities with stock to spare
+    for (int c = 0; c < inv->numCommodities && left > 0; c++) {
+        int spare = availableStock(inv, donor, c) - take[c];
+        int extra = spare < left ? spare : left;
+        take[c] += extra;
+        left -= extra;
+    }
+
+    int arrival = inv->now + distance * 60 / FREE_FLOW_SPEED_KMPH;
+    for (int c = 0; c < inv->numCommodities; c++) {
+        if (take[c] == 0) continue;
+        inv->onHand[STOCK_CELL(donor, c)] -= take[c];
+        adjustAvailable(inv, donor, c, -take[c]);
+        scheduleShipment(inv, donor, to, c, take[c], arrival);
+    }
+    return units;
+}
+
+// --- Shipments ---
+// Put units on the road to a city; the sender's stock must already have
+// been taken off (see dispatchPlan). Returns the shipment id.
+int scheduleShipment(Inventory* inv, int from, int to, int commodity,
+                     int units, int arrival) {
+    if (inv->numShipments == inv->capacity) {
+        int cap = inv->capacity * 2;
+        Shipment* grown = (Shipment*)realloc(inv->shipments, cap * sizeof(Shipment));
+        if (!grown) {
+            fprintf(stderr, "Inventory memory failed\n");
+            exit(1);
+        }
+        inv->shipments = grown;
+        inv->capacity = cap;
+    }
+    Shipment* s = &inv->shipments[inv->numShipments++];
+    s->id = inv->nextShipmentId++;
+    s->from = from;
+    s->to = to;
+    s->commodity = commodity;
+    s->units = units;
+    s->arrival = arrival;
+    inv->incoming[STOCK_CELL(to, commodity)] += units;
+    inv->stats.shipmentsCreated++;
+    return s->id;
+}
+
+// Move the clock forward and book every shipment that has arrived.
+// Returns the number delivered.
+int advanceInventory(Inventory* inv, int minutes) {
+    inv->now += minutes;
+    int delivered = 0, kept = 0;
+    for (int i = 0; i < inv->numShipments; i++) {
+        Shipment s = inv->shipments[i];
+        if (s.arrival > inv->now) {
+            inv->shipments[kept++] = s;
+            continue;
+        }
+        int cell = STOCK_CELL(s.to, s.commodity);
+        inv->incoming[cell] -= s.units;
+        inv->onHand[cell] += s.units;
+        adjustAvailable(inv, s.to, s.commodity, s.units);
+        inv->stats.unitsDelivered += s.units;
+        delivered++;
+    }
+    inv->numShipments = kept;
+    inv->stats.shipmentsDelivered += delivered;
+    return delivered;
+}
+
+// --- Matching ---
+static void addPlanLine(SupplyPlan* plan, int donor, int commodity, int units,
+                        int distance) {
+    if (plan->numLines == plan->capacity) {
+        int cap = plan->capacity ? plan->capacity * 2 : 16;
+        PlanLine* grown = (PlanLine*)realloc(plan->lines, cap * sizeof(PlanLine));
+        if (!grown) {
+            fprintf(stderr, "Inventory memory failed\n");
+            exit(1);
+        }
+        plan->lines = grown;
+        plan->capacity = cap;
+    }
+    plan->lines[plan->numLines++] = (PlanLine){ donor, commodity, units, distance };
+}
+
+// Reserve every commodity a request needs in one pass over its donors,
+// nearest first: each donor's row is read once and gives whatever it
+// has of the commodities still short. Returns the units still unmet.
+int matchCommodities(Graph* g, Inventory* inv, int city,
+                     const CommodityNeed needs[], int numNeeds, SupplyPlan* plan) {
+    double start = nowMs();
+    plan->city = city;
+    plan->numNeeds = 0;
+    plan->numLines = 0;
+
+    // Needs still open; a commodity with no stock anywhere is skipped
+    int open[MAX_COMMODITIES], numOpen = 0, unmet = 0;
+    for (int k = 0; k < numNeeds && k < MAX_COMMODITIES; k++) {
+        plan->needs[k] = needs[k];
+        plan->unmet[k] = needs[k].units;
+        plan->numNeeds++;
+        unmet += needs[k].units;
+        if (needs[k].units > 0 && inv->totalAvailable[needs[k].commodity] > 0)
+            open[numOpen++] = k;
+    }
+
+    unsigned int eligible[CITY_MASK_WORDS], reach[CITY_MASK_WORDS];
+    DonorCriteria crit = { 0, 6, INF, city };
+    buildDonorMask(g, NULL, &crit, eligible);
+    componentMask(g, city, reach);
+    int any = 0;
+    for (int w = 0; w < CITY_MASK_WORDS; w++) {
+        eligible[w] &= reach[w];
+        any |= eligible[w] != 0;
+    }
+
+    if (numOpen > 0 && any) {
+        int dist[MAX_CITIES], parent[MAX_CITIES];
+        cachedDijkstra(g, city, dist, parent);
+
+        // Insertion sort of eligible donors, nearest first
+        int order[MAX_CITIES], count = 0;
+        for (int i = 0; i < g->numCities; i++) {
+            if (!CITY_MASK_TEST(eligible, i) || dist[i] == INF) continue;
+            int k = count++;
+            while (k > 0 && dist[order[k - 1]] > dist[i]) {
+                order[k] = order[k - 1];
+                k--;
+            }
+            order[k] = i;
+        }
+
+        for (int d = 0; d < count && numOpen > 0; d++) {
+            int donor = order[d];
+            const int* onHand = &inv->onHand[STOCK_CELL(donor, 0)];
+            int* reserved = &inv->reserved[STOCK_CELL(donor, 0)];
+            inv->stats.donorsScanned++;
+
+            for (int o = 0; o < numOpen; ) {
+                int k = open[o], c = plan->needs[k].commodity;
+                int give = onHand[c] - reserved[c];
+                if (give > plan->unmet[k]) give = plan->unmet[k];
+                if (give > 0) {
+                    reserved[c] += give;
+                    adjustAvailable(inv, donor, c, -give);
+                    plan->unmet[k] -= give;
+                    unmet -= give;
+                    addPlanLine(plan, donor, c, give, dist[donor]);
+                }
+                // Filled, or nothing left anywhere: close the need
+                if (plan->unmet[k] == 0 || inv->totalAvailable[c] == 0)
+                    open[o] = open[--numOpen];
+                else
+                    o++;
+            }
+        }
+    }
+
+    inv->stats.matches++;
+    inv->stats.matchMs = nowMs() - start;
+    return unmet;
+}
+
+// Ship every reserved line: stock leaves the donor now and arrives after
+// the road distance at free-flow speed. Returns shipments created.
+int dispatchPlan(Inventory* inv, SupplyPlan* plan) {
+    for (int i = 0; i < plan->numLines; i++) {
+        const PlanLine* l = &plan->lines[i];
+        int cell = STOCK_CELL(l->donor, l->commodity);
+        inv->reserved[cell] -= l->units;
+        inv->onHand[cell] -= l->units;
+        int travel = l->distance * 60 / FREE_FLOW_SPEED_KMPH;
+        scheduleShipment(inv, l->donor, plan->city, l->commodity, l->units,
+                         inv->now + travel);
+    }
+    int shipped = plan->numLines;
+    plan->numLines = 0;
+    return shipped;
+}
+
+// Hand reserved units back to their donors
+void releasePlan(Inventory* inv, SupplyPlan* plan) {
+    for (int i = 0; i < plan->numLines; i++) {
+        const PlanLine* l = &plan->lines[i];
+        inv->reserved[STOCK_CELL(l->donor, l->commodity)] -= l->units;
+        adjustAvailable(inv, l->donor, l->commodity, l->units);
+    }
+    plan->numLines = 0;
+}
+
+void freeSupplyPlan(SupplyPlan* plan) {
+    free(plan->lines);
+    plan->lines = NULL;
+    plan->numLines = 0;
+    plan->capacity = 0;
+}
+
+// --- Reporting ---
+void printInventory(const Graph* g, const Inventory* inv) {
+    int shown = inv->numCommodities < INVENTORY_COLUMNS_SHOWN
+                ? inv->numCommodities : INVENTORY_COLUMNS_SHOWN;
+    printf("Ledger clock: %dh %02dm | Commodities: %d | Shipments in transit: %d\n\n",
+           inv->now / 60, inv->now % 60, inv->numCommodities, inv->numShipments);
+
+    printf("  %-15s", "City");
+    for (int c = 0; c < shown; c++)
+        printf(" | %-16.16s", inv->commodity[c]);
+    printf("\n");
+    for (int i = 0; i < g->numCities; i++) {
+        printf("  %-15s", g->cities.name[i]);
+        for (int c = 0; c < shown; c++) {
+            int cell = STOCK_CELL(i, c);
+            char text[32];
+            snprintf(text, sizeof(text), "%d", inv->onHand[cell]);
+            if (inv->reserved[cell])
+                snprintf(text + strlen(text), sizeof(text) - strlen(text),
+                         " r%d", inv->reserved[cell]);
+            if (inv->incoming[cell])
+                snprintf(text + strlen(text), sizeof(text) - strlen(text),
+                         " +%d", inv->incoming[cell]);
+            printf(" | %-16s", text);
+        }
+        printf("\n");
+    }
+    printf("\n  on hand, r = reserved, + = incoming");
+    if (shown < inv->numCommodities)
+        printf(" (first %d commodities shown)", shown);
+    printf("\n");
+}
+
+void printShipments(const Graph* g, const Inventory* inv) {
+    if (inv->numShipments == 0) {
+        printf("No shipments in transit.\n");
+        return;
+    }
+    printf("Shipments in transit:\n");
+    for (int i = 0; i < inv->numShipments; i++) {
+        const Shipment* s = &inv->shipments[i];
+        int eta = s->arrival - inv->now;
+        printf("  #%-4d %-15s → %-15s | %-12s %6d | in %dh %02dm\n", s->id,
+               s->from == SUPPLIER_EXTERNAL ? "(supplier)" : g->cities.name[s->from],
+               g->cities.name[s->to], inv->commodity[s->commodity], s->units,
+               eta / 60, eta % 60);
+    }
+}
+
+void printSupplyPlan(const Graph* g, const Inventory* inv, const SupplyPlan* plan) {
+    printf("Plan for %s:\n", g->cities.name[plan->city]);
+    for (int i = 0; i < plan->numLines; i++) {
+        const PlanLine* l = &plan->lines[i];
+        printf("  %-15s | %-12s %6d | %d km\n", g->cities.name[l->donor],
+               inv->commodity[l->commodity], l->units, l->distance);
+    }
+    for (int k = 0; k < plan->numNeeds; k++) {
+        if (plan->unmet[k] > 0)
+            printf("  Short: %-12s %6d of %d\n", inv->commodity[plan->needs[k].commodity],
+                   plan->unmet[k], plan->needs[k].units);
+    }
+}
+
+void printInventoryStats(const Inventory* inv) {
+    printf("Inventory      | Commodities: %d | Shipments: %lu (delivered %lu)\n",
+           inv->numCommodities, inv->stats.shipmentsCreated, inv->stats.shipmentsDelivered);
+    printf("%-14s | Matches: %lu | Donors scanned: %lu | Last match: %.3f ms\n", "",
+           inv->stats.matches, inv->stats.donorsScanned, inv->stats.matchMs);
+}
@@ -0,0 +1,110 @@
+// --- FILE: inventory.h ---
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include "graph.h"
+
+#define SHIPMENTS_INITIAL 64
+#define INVENTORY_COLUMNS_SHOWN 6
+#define SUPPLIER_EXTERNAL -1        // Shipment source outside the network
+
+// Ledger cell for one city and commodity (rows are cities, city-major)
+#define STOCK_CELL(city, c) ((city) * MAX_COMMODITIES + (c))
+
+// Units on the way to a city
+typedef struct Shipment {
+    int id;
+    int from;                   // Donor city or SUPPLIER_EXTERNAL
+    int to;
+    int commodity;
+    int units;
+    int arrival;                // Ledger clock, minutes
+} Shipment;
+
+// Ledger metrics
+typedef struct InventoryStats {
+    unsigned long shipmentsCreated;
+    unsigned long shipmentsDelivered;
+    unsigned long unitsDelivered;
+    unsigned long matches;
+    unsigned long donorsScanned;
+    double matchMs;             // Time of the last match
+} InventoryStats;
+
+// Per-city, per-commodity stock. A unit is on hand (in the city's store),
+// reserved (on hand but promised to a plan) or incoming (in a shipment).
+// available = onHand - reserved.
+typedef struct Inventory {
+    int numCommodities;
+    char commodity[MAX_COMMODITIES][MAX_NAME_LEN];
+    int* onHand;                // MAX_CITIES x MAX_COMMODITIES
+    int* reserved;
+    int* incoming;
+    long totalAvailable[MAX_COMMODITIES];
+    int* cityAvailable;         // Attached graph's availableResources, kept equal
+                                // to each city's available units (or NULL)
+    Shipment* shipments;        // In transit, unordered
+    int numShipments;
+    int capacity;
+    int nextShipmentId;
+    int now;                    // Ledger clock, minutes
+    InventoryStats stats;
+} Inventory;
+
+// Units of one commodity wanted by a request
+typedef struct CommodityNeed {
+    int commodity;
+    int units;
+} CommodityNeed;
+
+// One donor's contribution of one commodity
+typedef struct PlanLine {
+    int donor;
+    int commodity;
+    int units;
+    int distance;
+} PlanLine;
+
+// Reserved stock for one request, awaiting dispatch or release
+typedef struct SupplyPlan {
+    int city;
+    int numNeeds;
+    CommodityNeed needs[MAX_COMMODITIES];
+    int unmet[MAX_COMMODITIES];     // Per need
+    PlanLine* lines;
+    int numLines;
+    int capacity;
+} SupplyPlan;
+
+// Ledger lifecycle
+Inventory* createInventory(void);
+void freeInventory(Inventory* inv);
+int addCommodity(Inventory* inv, const char* name);
+int findCommodity(const Inventory* inv, const char* name);
+void setStock(Inventory* inv, int city, int commodity, int units);
+int availableStock(const Inventory* inv, int city, int commodity);
+
+// Make the ledger the graph's source of stock: availableResources is
+// rebuilt from it and follows every ledger change from then on
+void attachInventory(Graph* g, Inventory* inv);
+int drawStock(Inventory* inv, int donor, int to, int units, int distance);
+
+// Shipments
+int scheduleShipment(Inventory* inv, int from, int to, int commodity,
+                     int units, int arrival);
+int advanceInventory(Inventory* inv, int minutes);
+
+// Matching (reserve), then dispatch or release
+int matchCommodities(Graph* g, Inventory* inv, int city,
+                     const CommodityNeed needs[], int numNeeds, SupplyPlan* plan);
+int dispatchPlan(Inventory* inv, SupplyPlan* plan);
+void releasePlan(Inventory* inv, SupplyPlan* plan);
+void freeSupplyPlan(SupplyPlan* plan);
+
+// Reporting
+void printInventory(const Graph* g, const Inventory* inv);
+void printShipments(const Graph* g, const Inventory* inv);
+void printSupplyPlan(const Graph* g, const Inventory* inv, const SupplyPlan* plan);
+void printInventoryStats(const Inventory* inv);
+
+#endif // INVENTORY_H
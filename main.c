@@ -2,6 +2,19 @@
 #include "graph.h"
 #include "dijkstra.h"
 #include "resources.h"
+#include "spatial.h"
+#include "donorfilter.h"
+#include "convoy.h"
+#include "timeroute.h"
+#include "distcache.h"
+#include "simulation.h"
+#include "scenario.h"
+#include "analysis.h"
+#include "connectivity.h"
+#include "partition.h"
+#include "statusexport.h"
+#include "fairness.h"
+#include "inventory.h"
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -29,9 +42,41 @@ void initializeSampleNetwork(Graph* g) {
     addEdge(g, 2, 4, 190);    // Haridwar - Haldwani
     addEdge(g, 1, 3, 275);    // Rishikesh - Nainital
 
+    // Landslide-prone stretch: slow at night, free-flowing by day
+    int minutes[] = {0, 240, 450, 1080, 1260};
+    int travel[] = {540, 540, 330, 330, 540};
+    int nightSlow = addTravelProfile(g, minutes, travel, 5);
+    setRoadRestrictions(g, 4, 5, nightSlow, 0, ALL_VEHICLES);
+
+    // Narrow hill road: no heavy vehicles
+    setRoadRestrictions(g, 6, 5, -1, 0,
+                        VEHICLE_BIT(VEHICLE_LIGHT) | VEHICLE_BIT(VEHICLE_TRUCK));
+
+    // Weak bridge: limited tonnage
+    setRoadRestrictions(g, 1, 3, -1, 200, ALL_VEHICLES);
+
     printf("\n Sample disaster relief network initialized with 7 Uttarakhand cities.\n");
 }
 
+// Stock the sample cities by resource type
+void initializeSampleInventory(Inventory* inv, int numCities) {
+    const char* kinds[] = {"Food", "Water", "Medicine", "Shelter"};
+    int stock[7][4] = {
+        {300, 400, 80, 60},     // Dehradun
+        {150, 200, 40, 30},     // Rishikesh
+        {400, 500, 90, 70},     // Haridwar
+        {100, 150, 30, 20},     // Nainital
+        {350, 400, 60, 50},     // Haldwani
+        {200, 250, 40, 40},     // Pithoragarh
+        {180, 220, 30, 35}      // Almora
+    };
+    for (int c = 0; c < 4; c++)
+        addCommodity(inv, kinds[c]);
+    for (int i = 0; i < numCities && i < 7; i++)
+        for (int c = 0; c < 4; c++)
+            setStock(inv, i, c, stock[i][c]);
+}
+
 // Add a new city to the network
 void addNewCity(Graph* g) {
     printf("\n--------------------------------------------------------------------\n");
@@ -48,14 +93,42 @@ void addNewCity(Graph* g) {
 
     int population = getIntInput("Enter population: ", 1000, 50000000);
     int damageLevel = getIntInput("Enter damage level (0-10): ", 0, 10);
-    int resources = getIntInput("Enter available resources: ", 0, 10000);
+
+    // With a ledger, stock is entered per commodity and the count follows it
+    Inventory* inv = g->inventory;
+    int stock[MAX_COMMODITIES], resources = 0;
+    if (inv) {
+        for (int c = 0; c < inv->numCommodities; c++) {
+            char prompt[MAX_NAME_LEN + 32];
+            snprintf(prompt, sizeof(prompt), "Units of %s in stock: ", inv->commodity[c]);
+            stock[c] = getIntInput(prompt, 0, 10000);
+        }
+    } else {
+        resources = getIntInput("Enter available resources: ", 0, 10000);
+    }
     double lat = getDoubleInput("Enter latitude: ");
     double lon = getDoubleInput("Enter longitude: ");
 
-    addCity(g, g->numCities, name, population, damageLevel, resources, lat, lon);
+    int id = g->numCities;
+    addCity(g, id, name, population, damageLevel, resources, lat, lon);
+    if (inv)
+        for (int c = 0; c < inv->numCommodities; c++)
+            setStock(inv, id, c, stock[c]);
     printf("\n City '%s' added successfully!\n", name);
 }
 
+// Re-customise the regions a road edit touched (only once an overlay exists)
+void reportRegionUpdate(Graph* g) {
+    if (!g->regions) return;
+    unsigned int touched;
+    int count = syncRegionOverlay(g, g->regions, &touched);
+    double ms = 0.0;
+    for (int r = 0; r < g->regions->numRegions; r++)
+        if (touched & (1u << r)) ms += g->regions->cells[r].customizeMs;
+    printf("Re-customised %d of %d region(s) in %.3f ms\n",
+           count, g->regions->numRegions, ms);
+}
+
 // Add a road between two cities
 void addNewRoad(Graph* g) {
     printf("\n-------------------------------------------------------------\n");
@@ -69,7 +142,7 @@ void addNewRoad(Graph* g) {
 
     printf("Available cities:\n");
     for (int i = 0; i < g->numCities; i++) {
-        printf("  %d. %s\n", i, g->cities[i].name);
+        printf("  %d. %s\n", i, g->cities.name[i]);
     }
 
     int src = getIntInput("\nEnter source city ID: ", 0, g->numCities - 1);
@@ -84,7 +157,39 @@ void addNewRoad(Graph* g) {
 
     addEdge(g, src, dest, distance);
     printf("\nRoad added: %s ↔ %s (%d km)\n",
-           g->cities[src].name, g->cities[dest].name, distance);
+           g->cities.name[src], g->cities.name[dest], distance);
+    reportRegionUpdate(g);
+}
+
+// Close a road (landslide, washed-out bridge)
+void closeExistingRoad(Graph* g) {
+    printf("\n-------------------------------------------------------------\n");
+    printf("!                         CLOSE ROAD                                !\n");
+    printf("-------------------------------------------------------------\n\n");
+
+    if (g->numCities < 2) {
+        printf(" Need at least 2 cities!\n");
+        return;
+    }
+
+    printf("Available cities:\n");
+    for (int i = 0; i < g->numCities; i++) {
+        printf("  %d. %s\n", i, g->cities.name[i]);
+    }
+
+    int src = getIntInput("\nEnter first city ID: ", 0, g->numCities - 1);
+    int dest = getIntInput("Enter second city ID: ", 0, g->numCities - 1);
+
+    if (closeRoad(g, src, dest) == 0) {
+        printf(" No road between %s and %s.\n",
+               g->cities.name[src], g->cities.name[dest]);
+        return;
+    }
+    printf("\nRoad closed: %s ↔ %s\n", g->cities.name[src], g->cities.name[dest]);
+    if (!citiesConnected(g, src, dest))
+        printf("Network split: %s and %s can no longer reach each other.\n",
+               g->cities.name[src], g->cities.name[dest]);
+    reportRegionUpdate(g);
 }
 
 // Raise a disaster request
@@ -101,7 +206,7 @@ void raiseDisasterRequest(Graph* g, PriorityQueue* pq, HashMap* map) {
     printf("Cities in network:\n");
     for (int i = 0; i < g->numCities; i++) {
         printf("  %d. %s (Damage Level: %d/10)\n",
-               i, g->cities[i].name, g->cities[i].damageLevel);
+               i, g->cities.name[i], g->cities.damageLevel[i]);
     }
 
     int cityId = getIntInput("\nEnter disaster city ID: ", 0, g->numCities - 1);
@@ -109,24 +214,427 @@ void raiseDisasterRequest(Graph* g, PriorityQueue* pq, HashMap* map) {
     int resourcesNeeded = getIntInput("Enter resources needed: ", 1, 10000);
 
     CityRequest req;
+    req.requestId = -1;
     req.cityId = cityId;
-    strncpy(req.cityName, g->cities[cityId].name, MAX_NAME_LEN - 1);
+    strncpy(req.cityName, g->cities.name[cityId], MAX_NAME_LEN - 1);
     req.cityName[MAX_NAME_LEN - 1] = '\0';
     req.urgency = urgency;
     req.resourcesNeeded = resourcesNeeded;
     req.status = PENDING;
 
     insertRequest(pq, req);
-    insertHashEntry(map, req.cityName, PENDING, 0, "N/A", 0);
+    insertHashEntry(map, req.cityId, req.cityName, PENDING, 0, DONOR_NONE, "N/A", 0);
+}
+
+// Locate cities nearest to an incident coordinate
+void findNearestCities(Graph* g) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                 FIND NEAREST CITIES TO LOCATION                   !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities == 0) {
+        printf(" No cities in the network!\n");
+        return;
+    }
+
+    double lat = getDoubleInput("Enter incident latitude: ");
+    double lon = getDoubleInput("Enter incident longitude: ");
+    int k = getIntInput("How many nearest cities to list: ", 1, g->numCities);
+
+    SpatialIndex* idx = getSpatialIndex(g);
+    double snapKm;
+    int snapped = snapToNearestCity(idx, lat, lon, &snapKm);
+    printf("\nIncident snapped to: %s (%.1f km away)\n\n",
+           g->cities.name[snapped], snapKm);
+
+    int ids[MAX_CITIES];
+    double km[MAX_CITIES];
+    int n = findKNearestCities(idx, lat, lon, k, ids, km);
+    for (int i = 0; i < n; i++) {
+        int id = ids[i];
+        printf("  %d. %-15s %7.1f km | Resources: %d | Damage: %d/10\n",
+               i + 1, g->cities.name[id], km[i],
+               g->cities.availableResources[id], g->cities.damageLevel[id]);
+    }
+}
+
+// Plan multi-stop convoys for all pending requests
+void planReliefConvoys(Graph* g, PriorityQueue* pq) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                     PLAN RELIEF CONVOYS                           !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (isPQEmpty(pq)) {
+        printf(" No pending requests to route.\n");
+        return;
+    }
+
+    // Depots: lightly damaged cities holding stock
+    unsigned int depots[CITY_MASK_WORDS];
+    DonorCriteria crit = { 1, 2, INF, -1 };
+    int numDepots = buildDonorMask(g, NULL, &crit, depots);
+    if (numDepots == 0) {
+        printf(" No depot cities available (damage <= 2 with stock).\n");
+        return;
+    }
+
+    int perDepot = getIntInput("Trucks per depot: ", 1, MAX_TRUCKS / numDepots > 0 ? MAX_TRUCKS / numDepots : 1);
+    int capacity = getIntInput("Truck capacity (units): ", 1, 100000);
+    int vehicle = getIntInput("Vehicle class (0=light, 1=truck, 2=heavy): ", 0, 2);
+
+    Truck trucks[MAX_TRUCKS];
+    int numTrucks = 0;
+    for (int i = 0; i < g->numCities; i++) {
+        if (!CITY_MASK_TEST(depots, i)) continue;
+        for (int t = 0; t < perDepot && numTrucks < MAX_TRUCKS; t++) {
+            trucks[numTrucks].depotCity = i;
+            trucks[numTrucks].capacity = capacity;
+            trucks[numTrucks].vehicle = (VehicleClass)vehicle;
+            numTrucks++;
+        }
+    }
+
+    ConvoyPlan* plan = planConvoys(g, trucks, numTrucks, pq->requests, pq->size,
+                                   CONVOY_TIME_BUDGET_MS);
+    printf("\n");
+    printConvoyPlan(g, plan, trucks);
+
+    // Log each trip with its full route
+    char route[1024], stops[512];
+    for (int r = 0; r < plan->numRoutes; r++) {
+        const ConvoyRoute* cr = &plan->routes[r];
+        int len = 0;
+        stops[0] = '\0';
+        for (int k = 0; k < cr->numStops && len < (int)sizeof(stops); k++)
+            len += snprintf(stops + len, sizeof(stops) - len, "%s%s", k ? ", " : "",
+                            g->cities.name[plan->stops[cr->stops[k]].cityId]);
+        formatConvoyRoute(g, plan, cr, route, sizeof(route));
+        logAllocation(stops, g->cities.name[cr->depotCity], cr->load, cr->length, route);
+    }
+    printf("\nConvoy plan logged to file.\n");
+    freeConvoyPlan(plan);
+}
+
+// Earliest-arrival route for a departure time, vehicle and load
+void timeDependentRouteQuery(Graph* g) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                 TIME-DEPENDENT ROUTE QUERY                        !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities < 2) {
+        printf(" Need at least 2 cities!\n");
+        return;
+    }
+
+    for (int i = 0; i < g->numCities; i++)
+        printf("  %d. %s\n", i, g->cities.name[i]);
+
+    int src = getIntInput("\nEnter source city ID: ", 0, g->numCities - 1);
+    int dest = getIntInput("Enter destination city ID: ", 0, g->numCities - 1);
+    int hour = getIntInput("Departure hour (0-23): ", 0, 23);
+    int vehicle = getIntInput("Vehicle class (0=light, 1=truck, 2=heavy): ", 0, 2);
+    int load = getIntInput("Load (units): ", 0, 100000);
+
+    int arrival[MAX_CITIES], parent[MAX_CITIES];
+    dijkstraTimeDependent(g, src, hour * 60, (VehicleClass)vehicle, load,
+                          arrival, parent);
+
+    if (arrival[dest] == INF) {
+        printf("\nNo route for this vehicle and load.\n");
+        return;
+    }
+
+    int eta = (hour * 60 + arrival[dest]) % MINUTES_PER_DAY;
+    printf("\nTravel time: %dh %02dm | Arrives at %02d:%02d\n",
+           arrival[dest] / 60, arrival[dest] % 60, eta / 60, eta % 60);
+    printShortestPath(g, src, dest, parent);
+}
+
+// Show allocator usage of long-lived structures
+void displaySystemStats(Graph* g, HashMap* map, const StatusExporter* ex,
+                        const Inventory* inv) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                      SYSTEM STATISTICS                            !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    printf("Cities: %d / %d | Graph version: %u\n\n", g->numCities, MAX_CITIES,
+           g->version);
+    printAllocStats("Road edges", &g->edgePool.stats);
+    printf("\n");
+    printAllocStats("Status entries", &map->entryPool.stats);
+    printf("\n");
+    printCacheStats(getDistanceCache(g));
+    printf("\n");
+    printConnectivityStats(getConnectivityIndex(g));
+    printf("\n");
+    printInventoryStats(inv);
+    if (ex->active) {
+        printf("\n");
+        printStatusExportStats(ex);
+    }
+}
+
+// Replay synthetic disasters against the allocation policy
+void runDisasterSimulation(Graph* g) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                    DISASTER SIMULATION                            !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities < 2) {
+        printf(" Need at least 2 cities!\n");
+        return;
+    }
+
+    SimConfig cfg = defaultSimConfig();
+    cfg.seed = (unsigned long long)getIntInput("Enter random seed: ", 0, 1000000000);
+    cfg.durationHours = 24.0 * getIntInput("Enter simulated days (1-3650): ", 1, 3650);
+    cfg.meanInterarrivalHours = getIntInput("Enter mean hours between disasters (1-72): ", 1, 72);
+
+    printf("\nSimulating %.0f days on a copy of the network...\n",
+           cfg.durationHours / 24.0);
+    SimReport report;
+    runSimulation(g, &cfg, &report);
+    printSimReport(g, &report);
+}
+
+// Many randomised scenarios: damage fields and road failures
+void runScenarioAnalysis(Graph* g) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                 MONTE CARLO SCENARIO ANALYSIS                     !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities < 2) {
+        printf(" Need at least 2 cities!\n");
+        return;
+    }
+
+    ScenarioConfig cfg = defaultScenarioConfig();
+    cfg.numScenarios = getIntInput("Enter number of scenarios (10-100000): ", 10, 100000);
+    cfg.seed = (unsigned long long)getIntInput("Enter master seed: ", 0, 1000000000);
+    cfg.sim.durationHours = 24.0 * getIntInput("Enter simulated days per scenario (1-365): ", 1, 365);
+
+    printf("\nRunning %d scenarios...\n", cfg.numScenarios);
+    ScenarioSummary* summary = runScenarios(g, &cfg);
+    printScenarioSummary(g, summary);
+    freeScenarioSummary(summary);
+}
+
+// Bridges, articulation cities, busiest roads and costliest closures
+void runVulnerabilityAnalysis(Graph* g) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                 NETWORK VULNERABILITY ANALYSIS                    !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities < 2) {
+        printf(" Need at least 2 cities!\n");
+        return;
+    }
+
+    int sample = getIntInput("Betweenness source cities to sample (0 = all): ",
+                             0, g->numCities);
+    VulnerabilityReport* report = analyzeNetwork(g, sample, SIM_DEFAULT_SEED);
+    printVulnerabilityReport(g, report);
+    freeVulnerabilityReport(report);
+}
+
+// Components and pending requests no donor can reach
+void displayConnectivityReport(Graph* g, PriorityQueue* pq) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                     CONNECTIVITY REPORT                           !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities == 0) {
+        printf(" No cities in the network!\n");
+        return;
+    }
+
+    printConnectivityReport(g);
+
+    int isolated = 0;
+    for (int i = 0; i < pq->size; i++) {
+        const CityRequest* r = &pq->requests[i];
+        if (countReachableDonors(g, r->cityId) > 0) continue;
+        if (!isolated)
+            printf("\nPending requests with no reachable donor:\n");
+        printf("  %-15s | Urgency %d | Need %d\n",
+               r->cityName, r->urgency, r->resourcesNeeded);
+        isolated++;
+    }
+    if (!isolated && pq->size > 0)
+        printf("\nEvery pending request has a reachable donor.\n");
+}
+
+// Partition into regions and route across their boundary shortcuts
+void regionPartitionRouting(Graph* g) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                  REGION PARTITION & ROUTING                       !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    if (g->numCities < 2) {
+        printf(" Need at least 2 cities!\n");
+        return;
+    }
+
+    int maxRegions = g->numCities < MAX_REGIONS ? g->numCities : MAX_REGIONS;
+    int k = getIntInput("Number of regions: ", 1, maxRegions);
+    RegionOverlay* ov = rebuildRegionOverlay(g, k);
+    printf("\n");
+    printRegionOverlay(g, ov);
+
+    printf("\nAvailable cities:\n");
+    for (int i = 0; i < g->numCities; i++)
+        printf("  %d. %s\n", i, g->cities.name[i]);
+    int src = getIntInput("\nEnter source city ID: ", 0, g->numCities - 1);
+    int dest = getIntInput("Enter destination city ID: ", 0, g->numCities - 1);
+
+    unsigned long before = ov->stats.settled;
+    int d = overlayDistance(g, ov, src, dest);
+    unsigned long settled = ov->stats.settled - before;
+
+    int exact = getShortestDistance(g, src, dest);
+
+    printf("\n%s → %s\n", g->cities.name[src], g->cities.name[dest]);
+    if (d == INF) printf("  Overlay:  unreachable | %lu cities settled\n", settled);
+    else printf("  Overlay:  %d km | %lu cities settled\n", d, settled);
+    if (exact == INF) printf("  Dijkstra: unreachable | %d cities in network\n", g->numCities);
+    else printf("  Dijkstra: %d km | %d cities in network\n", exact, g->numCities);
+}
+
+// Write the full status table for dashboards; deltas follow every change
+void exportStatusForDashboards(HashMap* map, StatusExporter* ex) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                    EXPORT STATUS SNAPSHOT                         !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    int rows = exportStatusSnapshot(ex, map);
+    if (rows < 0) {
+        printf(" Could not write %s\n", ex->snapshotPath);
+        return;
+    }
+    printf("Snapshot %u: %d row(s) written to %s in %.3f ms\n",
+           ex->sequence, rows, ex->snapshotPath, ex->stats.lastMs);
+    printf("Changes from now on are appended to %s.\n", ex->deltaPath);
+
+    // Read it back the way a dashboard would
+    StatusTable* table = loadStatusTable(ex->snapshotPath, ex->deltaPath);
+    if (!table || table->rows != rows) {
+        printf(" Snapshot did not read back correctly!\n");
+    } else {
+        printf("Read back: %d row(s) at sequence %u\n", table->rows, table->sequence);
+    }
+    freeStatusTable(table);
+}
+
+// Split limited stock across every pending request at once
+void fairBatchAllocation(Graph* g, PriorityQueue* pq, HashMap* map) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                    FAIR BATCH ALLOCATION                          !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    allocateResourcesFairly(g, pq, map);
+}
+
+// Per-commodity stock, replenishment shipments and multi-commodity requests
+void manageInventory(Graph* g, Inventory* inv) {
+    printf("\n--------------------------------------------------------------------\n");
+    printf("!                    INVENTORY & SHIPMENTS                          !\n");
+    printf("--------------------------------------------------------------------\n\n");
+
+    printInventory(g, inv);
+    printf("\n");
+    printShipments(g, inv);
+
+    printf("\n1. Request supplies  2. Schedule replenishment  3. Advance clock\n");
+    printf("4. Add commodity     5. Back\n");
+    int action = getIntInput("Choose action: ", 1, 5);
+    if (action == 5) return;
+
+    if (action == 4) {
+        char name[MAX_NAME_LEN];
+        getStringInput("Commodity name: ", name, MAX_NAME_LEN);
+        if (addCommodity(inv, name) < 0)
+            printf(" Commodity table full (%d)!\n", MAX_COMMODITIES);
+        else
+            printf("\nCommodity '%s' tracked.\n", name);
+        return;
+    }
+
+    if (action == 3) {
+        int hours = getIntInput("Hours to advance (1-720): ", 1, 720);
+        int delivered = advanceInventory(inv, hours * 60);
+        printf("\n%d shipment(s) delivered.\n\n", delivered);
+        printInventory(g, inv);
+        return;
+    }
+
+    if (inv->numCommodities == 0 || g->numCities == 0) {
+        printf(" No commodities or cities yet!\n");
+        return;
+    }
+
+    printf("\nAvailable cities:\n");
+    for (int i = 0; i < g->numCities; i++)
+        printf("  %d. %s\n", i, g->cities.name[i]);
+    int city = getIntInput("\nEnter city ID: ", 0, g->numCities - 1);
+
+    if (action == 2) {
+        printf("\nCommodities:\n");
+        for (int c = 0; c < inv->numCommodities; c++)
+            printf("  %d. %s\n", c, inv->commodity[c]);
+        int c = getIntInput("Commodity ID: ", 0, inv->numCommodities - 1);
+        int units = getIntInput("Units: ", 1, 100000);
+        int hours = getIntInput("Hours until arrival (0-720): ", 0, 720);
+        int id = scheduleShipment(inv, SUPPLIER_EXTERNAL, city, c, units,
+                                  inv->now + hours * 60);
+        printf("\nShipment #%d of %d %s scheduled for %s.\n",
+               id, units, inv->commodity[c], g->cities.name[city]);
+        return;
+    }
+
+    // Multi-commodity request
+    CommodityNeed needs[MAX_COMMODITIES];
+    int numNeeds = 0;
+    for (int c = 0; c < inv->numCommodities; c++) {
+        char prompt[MAX_NAME_LEN + 32];
+        snprintf(prompt, sizeof(prompt), "Units of %s needed: ", inv->commodity[c]);
+        int units = getIntInput(prompt, 0, 100000);
+        if (units > 0) needs[numNeeds++] = (CommodityNeed){ c, units };
+    }
+    if (numNeeds == 0) {
+        printf(" Nothing requested.\n");
+        return;
+    }
+
+    SupplyPlan plan = {0};
+    int unmet = matchCommodities(g, inv, city, needs, numNeeds, &plan);
+    printf("\n");
+    printSupplyPlan(g, inv, &plan);
+    printf("Matched in %.3f ms%s\n", inv->stats.matchMs,
+           unmet > 0 ? " (partially)" : "");
+
+    if (plan.numLines > 0) {
+        int go = getIntInput("\nDispatch now (1) or release the reservation (0): ", 0, 1);
+        if (go) printf("\n%d shipment(s) on the road.\n", dispatchPlan(inv, &plan));
+        else {
+            releasePlan(inv, &plan);
+            printf("\nReservation released.\n");
+        }
+    }
+    freeSupplyPlan(&plan);
 }
 
 int main() {
     Graph* graph = createGraph(MAX_CITIES);
     PriorityQueue* pq = createPriorityQueue();
     HashMap* map = createHashMap();
+    StatusExporter exporter;
+    initStatusExporter(&exporter, STATUS_SNAPSHOT_FILE, STATUS_DELTA_FILE);
 
     // Initialize with sample data (Uttarakhand)
     initializeSampleNetwork(graph);
+    Inventory* inventory = createInventory();
+    initializeSampleInventory(inventory, graph->numCities);
+    attachInventory(graph, inventory);
 
     int choice;
     int running = 1;
@@ -139,7 +647,7 @@ int main() {
         displayBanner();
         displayMainMenu();
 
-        choice = getIntInput("\nEnter your choice: ", 1, 8);
+        choice = getIntInput("\nEnter your choice: ", 1, 21);
 
         switch (choice) {
             case 1:
@@ -159,11 +667,13 @@ int main() {
 
             case 4:
                 raiseDisasterRequest(graph, pq, map);
+                exportStatusDelta(&exporter, map);
                 pressEnterToContinue();
                 break;
 
             case 5:
                 allocateResources(graph, pq, map);
+                exportStatusDelta(&exporter, map);
                 pressEnterToContinue();
                 break;
 
@@ -178,6 +688,72 @@ int main() {
                 break;
 
             case 8:
+                findNearestCities(graph);
+                pressEnterToContinue();
+                break;
+
+            case 9:
+                displaySystemStats(graph, map, &exporter, inventory);
+                pressEnterToContinue();
+                break;
+
+            case 10:
+                planReliefConvoys(graph, pq);
+                pressEnterToContinue();
+                break;
+
+            case 11:
+                timeDependentRouteQuery(graph);
+                pressEnterToContinue();
+                break;
+
+            case 12:
+                closeExistingRoad(graph);
+                pressEnterToContinue();
+                break;
+
+            case 13:
+                runDisasterSimulation(graph);
+                pressEnterToContinue();
+                break;
+
+            case 14:
+                runScenarioAnalysis(graph);
+                pressEnterToContinue();
+                break;
+
+            case 15:
+                runVulnerabilityAnalysis(graph);
+                pressEnterToContinue();
+                break;
+
+            case 16:
+                displayConnectivityReport(graph, pq);
+                pressEnterToContinue();
+                break;
+
+            case 17:
+                regionPartitionRouting(graph);
+                pressEnterToContinue();
+                break;
+
+            case 18:
+                exportStatusForDashboards(map, &exporter);
+                pressEnterToContinue();
+                break;
+
+            case 19:
+                fairBatchAllocation(graph, pq, map);
+                exportStatusDelta(&exporter, map);
+                pressEnterToContinue();
+                break;
+
+            case 20:
+                manageInventory(graph, inventory);
+                pressEnterToContinue();
+                break;
+
+            case 21:
                 printf("\nThank you for using the Disaster Relief System!\n");
                 printf("All allocation logs saved to: allocation_logs.txt\n\n");
                 running = 0;
@@ -191,6 +767,7 @@ int main() {
 
     // Cleanup
     freeGraph(graph);
+    freeInventory(inventory);
     free(pq);
     freeHashMap(map);
 
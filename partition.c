@@ -0,0 +1,527 @@
+// --- FILE: partition.c ---
+#include "partition.h"
+#include "dijkstra.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LEVELS 8
+
+// --- Multilevel Partitioning ---
+// One level of the coarsening hierarchy; a node stands for a group of
+// cities. Adjacency is compressed (CSR): node u's neighbours are
+// adj[first[u]] .. adj[first[u + 1] - 1], one entry per neighbour.
+typedef struct Level {
+    int n;
+    int* vwgt;                  // Cities in the node
+    int* first;                 // n + 1 offsets into adj / ewgt
+    int* adj;                   // Neighbour node
+    int* ewgt;                  // Roads between the two nodes
+    int* coarse;                // Node -> node of the next level
+} Level;
+
+static void allocLevel(Level* L, int n, int entries) {
+    L->n = n;
+    L->vwgt = (int*)malloc((n + 1) * sizeof(int));
+    L->first = (int*)malloc((n + 1) * sizeof(int));
+    L->adj = (int*)malloc((entries + 1) * sizeof(int));
+    L->ewgt = (int*)malloc((entries + 1) * sizeof(int));
+    L->coarse = (int*)malloc((n + 1) * sizeof(int));
+    if (!L->vwgt || !L->first || !L->adj || !L->ewgt || !L->coarse) {
+        fprintf(stderr, "Partition memory failed\n");
+        exit(1);
+    }
+}
+
+static void freeLevel(Level* L) {
+    free(L->vwgt);
+    free(L->first);
+    free(L->adj);
+    free(L->ewgt);
+    free(L->coarse);
+}
+
+// Heavy-edge matching: pair each node with the unmatched neighbour it
+// shares most roads with. Builds the coarser level and returns its size.
+static int coarsen(Level* fine, Level* next, int maxWeight) {
+    int n = fine->n, order[MAX_CITIES], degree[MAX_CITIES], match[MAX_CITIES];
+    int members[MAX_CITIES];            // Coarse node -> one of its fine nodes
+
+    for (int u = 0; u < n; u++) {
+        degree[u] = fine->first[u + 1] - fine->first[u];
+        match[u] = -1;
+    }
+    // Low-degree nodes first: they have the fewest chances to be matched
+    for (int i = 0; i < n; i++) {
+        int k = i;
+        order[i] = i;
+        while (k > 0 && degree[order[k - 1]] > degree[i]) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = i;
+    }
+
+    int* coarse = fine->coarse;
+    int size = 0;
+    for (int i = 0; i < n; i++) {
+        int u = order[i];
+        if (match[u] >= 0) continue;
+        int best = -1, bestW = 0;
+        for (int j = fine->first[u]; j < fine->first[u + 1]; j++) {
+            int v = fine->adj[j], w = fine->ewgt[j];
+            if (match[v] >= 0) continue;
+            if (fine->vwgt[u] + fine->vwgt[v] > maxWeight) continue;
+            if (best < 0 || w > bestW ||
+                (w == bestW && (fine->vwgt[v] < fine->vwgt[best] ||
+                                (fine->vwgt[v] == fine->vwgt[best] && v < best)))) {
+                best = v;
+                bestW = w;
+            }
+        }
+        match[u] = (best >= 0) ? best : u;
+        if (best >= 0) match[best] = u;
+        coarse[u] = size;
+        if (best >= 0) coarse[best] = size;
+        members[size++] = u;
+    }
+
+    // Merge the members' adjacency; roads inside a pair disappear
+    int entries = fine->first[n];
+    allocLevel(next, size, entries);
+    int sum[MAX_CITIES], seen[MAX_CITIES], count = 0;
+    for (int c = 0; c < size; c++) sum[c] = 0;
+    for (int c = 0; c < size; c++) {
+        int u = members[c], pair[2] = { u, match[u] };
+        int numSeen = 0;
+        next->first[c] = count;
+        next->vwgt[c] = 0;
+        for (int m = 0; m < (pair[1] == u ? 1 : 2); m++) {
+            int x = pair[m];
+            next->vwgt[c] += fine->vwgt[x];
+            for (int j = fine->first[x]; j < fine->first[x + 1]; j++) {
+                int d = coarse[fine->adj[j]];
+                if (d == c) continue;
+                if (sum[d] == 0) seen[numSeen++] = d;
+                sum[d] += fine->ewgt[j];
+            }
+        }
+        for (int i = 0; i < numSeen; i++) {
+            next->adj[count] = seen[i];
+            next->ewgt[count++] = sum[seen[i]];
+            sum[seen[i]] = 0;
+        }
+    }
+    next->first[size] = count;
+    return size;
+}
+
+// Greedy graph growing on the coarsest level: each part starts at a node
+// next to the parts already grown and absorbs its best-connected neighbours
+static void growInitialParts(const Level* L, int k, int part[]) {
+    int n = L->n, remaining = 0, unassigned = n;
+    for (int u = 0; u < n; u++) {
+        part[u] = -1;
+        remaining += L->vwgt[u];
+    }
+
+    for (int p = 0; p < k; p++) {
+        int target = (remaining + (k - p) - 1) / (k - p);
+        int weight = 0;
+        // Leave at least one node for each part still to grow
+        while (weight < target && unassigned > k - 1 - p) {
+            int best = -1, bestConn = -1;
+            for (int u = 0; u < n; u++) {
+                if (part[u] != -1) continue;
+                if (p == k - 1) {
+                    best = u;
+                    break;
+                }
+                // Connection to this part; seeds prefer the grown border
+                int conn = 0, border = 0;
+                for (int j = L->first[u]; j < L->first[u + 1]; j++) {
+                    int v = L->adj[j];
+                    if (part[v] == p) conn += L->ewgt[j];
+                    else if (part[v] >= 0) border += L->ewgt[j];
+                }
+                int score = (weight == 0) ? border : conn;
+                if (weight > 0 && conn == 0) continue;
+                if (score > bestConn) {
+                    best = u;
+                    bestConn = score;
+                }
+            }
+            // Part cannot grow further (disconnected): leave the rest for later parts
+            if (best < 0) break;
+            if (weight > 0 && p < k - 1 && weight + L->vwgt[best] > target + target / 2)
+                break;
+            part[best] = p;
+            weight += L->vwgt[best];
+            remaining -= L->vwgt[best];
+            unassigned--;
+        }
+    }
+    for (int u = 0; u < n; u++)
+        if (part[u] == -1) part[u] = k - 1;
+}
+
+// Boundary refinement: move nodes to the neighbouring part they share
+// most roads with while it cuts fewer roads (or evens out sizes) and keeps
+// every part within maxWeight and non-empty
+static void refineParts(const Level* L, int k, int part[], int maxWeight) {
+    int n = L->n, weight[MAX_REGIONS] = {0};
+    for (int u = 0; u < n; u++) weight[part[u]] += L->vwgt[u];
+
+    for (int pass = 0; pass < REFINE_PASSES; pass++) {
+        int moved = 0;
+        for (int u = 0; u < n; u++) {
+            int p = part[u], conn[MAX_REGIONS] = {0};
+            for (int j = L->first[u]; j < L->first[u + 1]; j++)
+                conn[part[L->adj[j]]] += L->ewgt[j];
+            if (weight[p] - L->vwgt[u] < 1) continue;
+
+            int best = -1, bestGain = 0;
+            for (int q = 0; q < k; q++) {
+                if (q == p || weight[q] + L->vwgt[u] > maxWeight) continue;
+                int gain = conn[q] - conn[p];
+                int overweight = weight[p] > maxWeight;
+                int evens = weight[p] > weight[q] + L->vwgt[u];
+                if (!overweight && conn[q] == 0) continue;
+                if (gain > 0 || (gain == 0 && evens) || overweight) {
+                    if (best < 0 || gain > bestGain) {
+                        best = q;
+                        bestGain = gain;
+                    }
+                }
+            }
+            if (best < 0) continue;
+            weight[p] -= L->vwgt[u];
+            weight[best] += L->vwgt[u];
+            part[u] = best;
+            moved++;
+        }
+        if (!moved) break;
+    }
+}
+
+// Partition cities into numRegions balanced regions with few cut roads.
+// Returns the number of roads between different regions.
+int partitionGraph(const Graph* g, int numRegions, int region[]) {
+    int n = g->numCities, k = numRegions;
+    if (k > n) k = n;
+    if (k > MAX_REGIONS) k = MAX_REGIONS;
+    if (k <= 1) {
+        for (int i = 0; i < n; i++) region[i] = 0;
+        return 0;
+    }
+
+    int numRoads = collectRoads(g, NULL, NULL);
+    int* roadSrc = (int*)malloc((2 * numRoads + 1) * sizeof(int));
+    if (!roadSrc) {
+        fprintf(stderr, "Partition memory failed\n");
+        exit(1);
+    }
+    int* roadDest = roadSrc + numRoads;
+    collectRoads(g, roadSrc, roadDest);
+
+    // Base level: one node per city, one entry per road end
+    Level levels[MAX_LEVELS];
+    Level* base = &levels[0];
+    allocLevel(base, n, 2 * numRoads);
+    memset(base->first, 0, (n + 1) * sizeof(int));
+    for (int r = 0; r < numRoads; r++) {
+        base->first[roadSrc[r] + 1]++;
+        base->first[roadDest[r] + 1]++;
+    }
+    for (int u = 0; u < n; u++) {
+        base->vwgt[u] = 1;
+        base->first[u + 1] += base->first[u];
+    }
+    int fill[MAX_CITIES];
+    memcpy(fill, base->first, n * sizeof(int));
+    for (int r = 0; r < numRoads; r++) {
+        int a = roadSrc[r], b = roadDest[r];
+        base->adj[fill[a]] = b;
+        base->ewgt[fill[a]++] = 1;
+        base->adj[fill[b]] = a;
+        base->ewgt[fill[b]++] = 1;
+    }
+
+    int maxWeight = (int)((1.0 + PARTITION_IMBALANCE) * n / k + 0.999);
+    int depth = 0;
+    while (depth + 1 < MAX_LEVELS && levels[depth].n > 2 * k) {
+        int before = levels[depth].n;
+        int after = coarsen(&levels[depth], &levels[depth + 1], maxWeight);
+        depth++;
+        if (after * 10 > before * 9) break;
+    }
+
+    int part[MAX_CITIES], finePart[MAX_CITIES];
+    growInitialParts(&levels[depth], k, part);
+    refineParts(&levels[depth], k, part, maxWeight);
+
+    // Project back down, refining at every level
+    for (int d = depth - 1; d >= 0; d--) {
+        for (int u = 0; u < levels[d].n; u++)
+            finePart[u] = part[levels[d].coarse[u]];
+        memcpy(part, finePart, levels[d].n * sizeof(int));
+        refineParts(&levels[d], k, part, maxWeight);
+    }
+    for (int d = 0; d <= depth; d++) freeLevel(&levels[d]);
+
+    int cut = 0;
+    for (int i = 0; i < n; i++) region[i] = part[i];
+    for (int r = 0; r < numRoads; r++)
+        cut += region[roadSrc[r]] != region[roadDest[r]];
+    free(roadSrc);
+    return cut;
+}
+
+// --- Overlay Customisation ---
+// Shortest distances from src using only roads inside one region
+static void regionDijkstra(Graph* g, const RegionOverlay* ov, int src, int r,
+                           int dist[]) {
+    int n = g->numCities;
+    MinHeap* heap = createMinHeap(n);
+    for (int v = 0; v < n; v++) {
+        dist[v] = INF;
+        heap->array[v] = &heap->nodes[v];
+        heap->array[v]->vertex = v;
+        heap->array[v]->distance = INF;
+        heap->pos[v] = v;
+    }
+    heap->size = n;
+    dist[src] = 0;
+    decreaseKey(heap, src, 0);
+
+    while (!isEmpty(heap)) {
+        int u = extractMin(heap)->vertex;
+        if (dist[u] == INF) break;
+        for (const EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            int v = e->destCity;
+            if (ov->region[v] != r || e->distance >= dist[v] - dist[u]) continue;
+            dist[v] = dist[u] + e->distance;
+            decreaseKey(heap, v, dist[v]);
+        }
+    }
+    freeMinHeap(heap);
+}
+
+// Recompute one region's boundary and clique; nothing outside it is read
+// beyond the region's own cut roads
+void customizeRegion(Graph* g, RegionOverlay* ov, int r) {
+    double start = nowMs();
+    RegionCell* cell = &ov->cells[r];
+    cell->numCities = 0;
+    cell->numBoundary = 0;
+
+    for (int i = 0; i < ov->numCities; i++) {
+        if (ov->region[i] != r) continue;
+        cell->numCities++;
+        ov->boundaryIndex[i] = -1;
+        for (const EdgeNode* e = g->adjList[i]; e; e = e->next) {
+            if (ov->region[e->destCity] != r) {
+                ov->boundaryIndex[i] = cell->numBoundary;
+                cell->boundary[cell->numBoundary++] = i;
+                break;
+            }
+        }
+    }
+
+    int nb = cell->numBoundary;
+    free(cell->clique);
+    cell->clique = (int*)malloc((nb * nb + 1) * sizeof(int));
+    if (!cell->clique) {
+        fprintf(stderr, "Overlay memory failed\n");
+        exit(1);
+    }
+
+    int dist[MAX_CITIES];
+    for (int a = 0; a < nb; a++) {
+        regionDijkstra(g, ov, cell->boundary[a], r, dist);
+        for (int b = 0; b < nb; b++)
+            cell->clique[a * nb + b] = dist[cell->boundary[b]];
+    }
+    cell->customizeMs = nowMs() - start;
+    ov->stats.regionCustomizations++;
+}
+
+// Each cut road is seen once, from its lower-numbered end
+static void countCutRoads(const Graph* g, RegionOverlay* ov) {
+    unsigned int seen[CITY_MASK_WORDS];
+    ov->cutRoads = 0;
+    for (int u = 0; u < g->numCities; u++) {
+        memset(seen, 0, sizeof(seen));
+        for (const EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            int v = e->destCity;
+            if (v <= u || CITY_MASK_TEST(seen, v)) continue;
+            CITY_MASK_SET(seen, v);
+            ov->cutRoads += ov->region[u] != ov->region[v];
+        }
+    }
+}
+
+// Partition the graph and customise every region
+RegionOverlay* buildRegionOverlay(Graph* g, int numRegions) {
+    RegionOverlay* ov = (RegionOverlay*)calloc(1, sizeof(RegionOverlay));
+    if (!ov) {
+        fprintf(stderr, "Overlay memory failed\n");
+        exit(1);
+    }
+    int k = numRegions;
+    if (k > g->numCities) k = g->numCities;
+    if (k > MAX_REGIONS) k = MAX_REGIONS;
+    if (k < 1) k = 1;
+
+    ov->numRegions = k;
+    ov->numCities = g->numCities;
+    ov->cutRoads = partitionGraph(g, k, ov->region);
+    for (int r = 0; r < k; r++)
+        customizeRegion(g, ov, r);
+    ov->version = g->version;
+    ov->stats.fullCustomizations++;
+    return ov;
+}
+
+// Lazily built overlay owned by the graph, brought up to date
+RegionOverlay* getRegionOverlay(Graph* g) {
+    if (!g->regions) {
+        int k = g->numCities / CITIES_PER_REGION;
+        g->regions = buildRegionOverlay(g, k < 2 ? 2 : k);
+    }
+    syncRegionOverlay(g, g->regions, NULL);
+    return g->regions;
+}
+
+// Replace the graph's overlay with a fresh partition
+RegionOverlay* rebuildRegionOverlay(Graph* g, int numRegions) {
+    freeRegionOverlay(g->regions);
+    g->regions = buildRegionOverlay(g, numRegions);
+    return g->regions;
+}
+
+// Replay edits since the last sync and re-customise only the regions
+// they touch. New cities join the smallest region. Returns the number of
+// regions recomputed; touched (if given) receives them as a bitmask.
+int syncRegionOverlay(Graph* g, RegionOverlay* ov, unsigned int* touched) {
+    unsigned int dirty = 0;
+    if (touched) *touched = 0;
+    if (ov->version == g->version) return 0;
+
+    int wrapped = g->version - ov->version >= EDIT_LOG_SIZE;
+    for (int c = ov->numCities; c < g->numCities; c++) {
+        int smallest = 0;
+        for (int r = 1; r < ov->numRegions; r++)
+            if (ov->cells[r].numCities < ov->cells[smallest].numCities) smallest = r;
+        ov->region[c] = smallest;
+        ov->boundaryIndex[c] = -1;
+        ov->cells[smallest].numCities++;
+        dirty |= 1u << smallest;
+    }
+    ov->numCities = g->numCities;
+
+    if (wrapped) {
+        dirty = (ov->numRegions >= 32) ? ~0u : (1u << ov->numRegions) - 1;
+        ov->stats.fullCustomizations++;
+    } else {
+        for (unsigned int v = ov->version + 1; v <= g->version; v++) {
+            const GraphEdit* e = getGraphEdit(g, v);
+            if (e->kind == EDIT_ADD_CITY || e->kind == EDIT_RESTRICT_ROAD) continue;
+            dirty |= 1u << ov->region[e->src];
+            dirty |= 1u << ov->region[e->dest];
+        }
+    }
+
+    int count = 0;
+    for (int r = 0; r < ov->numRegions; r++) {
+        if (!(dirty & (1u << r))) continue;
+        customizeRegion(g, ov, r);
+        count++;
+    }
+    countCutRoads(g, ov);
+    ov->version = g->version;
+    if (touched) *touched = dirty;
+    return count;
+}
+
+// --- Overlay Query ---
+// Dijkstra that uses every road in the source and target regions but
+// crosses any other region through its boundary clique in one step
+int overlayDistance(Graph* g, RegionOverlay* ov, int src, int dest) {
+    syncRegionOverlay(g, ov, NULL);
+    int n = g->numCities, dist[MAX_CITIES];
+    int rs = ov->region[src], rt = ov->region[dest];
+    MinHeap* heap = createMinHeap(n);
+
+    for (int v = 0; v < n; v++) {
+        dist[v] = INF;
+        heap->array[v] = &heap->nodes[v];
+        heap->array[v]->vertex = v;
+        heap->array[v]->distance = INF;
+        heap->pos[v] = v;
+    }
+    heap->size = n;
+    dist[src] = 0;
+    decreaseKey(heap, src, 0);
+    ov->stats.queries++;
+
+    while (!isEmpty(heap)) {
+        int u = extractMin(heap)->vertex;
+        if (dist[u] == INF || u == dest) break;
+        ov->stats.settled++;
+
+        int ru = ov->region[u];
+        int local = (ru == rs || ru == rt);
+        for (const EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            int v = e->destCity;
+            if (!local && ov->region[v] == ru) continue;
+            if (e->distance < dist[v] - dist[u]) {
+                dist[v] = dist[u] + e->distance;
+                decreaseKey(heap, v, dist[v]);
+            }
+        }
+        if (local) continue;
+
+        const RegionCell* cell = &ov->cells[ru];
+        int nb = cell->numBoundary, a = ov->boundaryIndex[u];
+        for (int b = 0; a >= 0 && b < nb; b++) {
+            int w = cell->clique[a * nb + b];
+            int v = cell->boundary[b];
+            if (w != INF && w < dist[v] - dist[u]) {
+                dist[v] = dist[u] + w;
+                decreaseKey(heap, v, dist[v]);
+            }
+        }
+    }
+    freeMinHeap(heap);
+    return dist[dest];
+}
+
+// --- Reporting ---
+void printRegionOverlay(const Graph* g, const RegionOverlay* ov) {
+    printf("Regions: %d | Cut roads: %d | Customisations: %lu (full: %lu)\n\n",
+           ov->numRegions, ov->cutRoads, ov->stats.regionCustomizations,
+           ov->stats.fullCustomizations);
+    for (int r = 0; r < ov->numRegions; r++) {
+        const RegionCell* cell = &ov->cells[r];
+        printf("  Region %d | %d cities | %d boundary | %.3f ms\n    ",
+               r, cell->numCities, cell->numBoundary, cell->customizeMs);
+        int first = 1;
+        for (int i = 0; i < ov->numCities; i++) {
+            if (ov->region[i] != r) continue;
+            printf("%s%s%s", first ? "" : ", ", g->cities.name[i],
+                   ov->boundaryIndex[i] >= 0 ? "*" : "");
+            first = 0;
+        }
+        printf("\n");
+    }
+    printf("\n  * boundary city\n");
+}
+
+void freeRegionOverlay(RegionOverlay* ov) {
+    if (!ov) return;
+    for (int r = 0; r < ov->numRegions; r++)
+        free(ov->cells[r].clique);
+    free(ov);
+}
@@ -0,0 +1,55 @@
+// --- FILE: partition.h ---
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "graph.h"
+
+#define MAX_REGIONS 16
+#define PARTITION_IMBALANCE 0.10    // Largest region may exceed n/k by 10%
+#define REFINE_PASSES 8
+#define CITIES_PER_REGION 8          // Default region size for getRegionOverlay
+
+// Shortcut table for one region: road distance between every pair of
+// its boundary cities using only roads inside the region
+typedef struct RegionCell {
+    int numCities;
+    int numBoundary;
+    int boundary[MAX_CITIES];       // City ids
+    int* clique;                    // numBoundary x numBoundary, INF if no inner route
+    double customizeMs;             // Time of the last recomputation
+} RegionCell;
+
+// Overlay metrics
+typedef struct OverlayStats {
+    unsigned long regionCustomizations;
+    unsigned long fullCustomizations;
+    unsigned long queries;
+    unsigned long settled;          // Cities settled by overlay queries
+} OverlayStats;
+
+// Partition plus boundary cliques, kept in step with the graph's edit log
+typedef struct RegionOverlay {
+    int numRegions;
+    int numCities;
+    int cutRoads;
+    int region[MAX_CITIES];         // City -> region
+    int boundaryIndex[MAX_CITIES];  // City -> slot in its region's boundary, -1 if inner
+    RegionCell cells[MAX_REGIONS];
+    unsigned int version;           // Graph version the cliques reflect
+    OverlayStats stats;
+} RegionOverlay;
+
+// Partitioning (multilevel: heavy-edge coarsening, greedy growing, boundary refinement)
+int partitionGraph(const Graph* g, int numRegions, int region[]);
+
+// Overlay
+RegionOverlay* buildRegionOverlay(Graph* g, int numRegions);
+RegionOverlay* getRegionOverlay(Graph* g);
+RegionOverlay* rebuildRegionOverlay(Graph* g, int numRegions);
+void customizeRegion(Graph* g, RegionOverlay* ov, int r);
+int syncRegionOverlay(Graph* g, RegionOverlay* ov, unsigned int* touched);
+int overlayDistance(Graph* g, RegionOverlay* ov, int src, int dest);
+void printRegionOverlay(const Graph* g, const RegionOverlay* ov);
+void freeRegionOverlay(RegionOverlay* ov);
+
+#endif // PARTITION_H
@@ -0,0 +1,83 @@
+// --- FILE: path.c ---
+#include "path.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Count vertices on the tree path src -> dest (-1 if none)
+static int pathLength(const int parent[], int src, int dest) {
+    int len = 1;
+    for (int v = dest; v != src; v = parent[v]) {
+        if (parent[v] == -1 || len > MAX_CITIES) return -1;
+        len++;
+    }
+    return len;
+}
+
+// Reconstruct into caller buffers
+int reconstructPath(const int parent[], const int dist[], int src, int dest,
+                    int outVertices[], int outCumulative[], int maxLen) {
+    int len = pathLength(parent, src, dest);
+    if (len < 0 || len > maxLen) return -1;
+
+    int k = len - 1;
+    for (int v = dest; k >= 0; v = parent[v], k--) {
+        outVertices[k] = v;
+        if (outCumulative) outCumulative[k] = dist[v];
+    }
+    return len;
+}
+
+// Build paths for several targets in one arena
+PathSet* buildPathSet(const int parent[], const int dist[], int src,
+                      const int targets[], int numTargets) {
+    PathSet* set = (PathSet*)malloc(sizeof(PathSet));
+    if (!set) {
+        fprintf(stderr, "Path memory failed\n");
+        exit(1);
+    }
+
+    // Size everything up front so the arena needs a single chunk
+    int total = 0;
+    for (int t = 0; t < numTargets; t++) {
+        int len = pathLength(parent, src, targets[t]);
+        if (len > 0) total += len;
+    }
+    arenaInit(&set->arena, numTargets * sizeof(Path) + 2 * total * sizeof(int) +
+                           (2 * numTargets + 1) * ARENA_ALIGN);
+
+    set->count = numTargets;
+    set->paths = (Path*)arenaAlloc(&set->arena, numTargets * sizeof(Path));
+    for (int t = 0; t < numTargets; t++) {
+        Path* p = &set->paths[t];
+        int len = pathLength(parent, src, targets[t]);
+        if (len < 0) {
+            p->length = 0;
+            p->vertices = p->cumulative = NULL;
+            continue;
+        }
+        p->vertices = (int*)arenaAlloc(&set->arena, len * sizeof(int));
+        p->cumulative = (int*)arenaAlloc(&set->arena, len * sizeof(int));
+        p->length = reconstructPath(parent, dist, src, targets[t],
+                                    p->vertices, p->cumulative, len);
+    }
+    return set;
+}
+
+// Free path set
+void freePathSet(PathSet* set) {
+    if (!set) return;
+    arenaDestroy(&set->arena);
+    free(set);
+}
+
+// Format path as names joined by arrows
+int formatPath(Graph* g, const Path* p, int reversed, char* buf, int bufSize) {
+    int len = 0;
+    buf[0] = '\0';
+    for (int k = 0; k < p->length && len < bufSize; k++) {
+        int v = p->vertices[reversed ? p->length - 1 - k : k];
+        len += snprintf(buf + len, bufSize - len, "%s%s",
+                        k ? " → " : "", g->cities.name[v]);
+    }
+    return len;
+}
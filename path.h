@@ -0,0 +1,36 @@
+// --- FILE: path.h ---
+#ifndef PATH_H
+#define PATH_H
+
+#include "graph.h"
+#include "allocator.h"
+
+// Route as data: vertices from the search source outwards
+typedef struct Path {
+    int length;             // Vertex count, 0 if unreachable
+    int* vertices;
+    int* cumulative;        // Distance from the source at each vertex
+} Path;
+
+// Paths to many targets taken from one search tree
+typedef struct PathSet {
+    int count;
+    Path* paths;            // Same order as the requested targets
+    Arena arena;            // Owns every buffer above
+} PathSet;
+
+// Reconstruct src -> dest into caller buffers (no recursion).
+// Returns the vertex count, or -1 if dest is unreachable or the
+// path does not fit in maxLen.
+int reconstructPath(const int parent[], const int dist[], int src, int dest,
+                    int outVertices[], int outCumulative[], int maxLen);
+
+// Paths from one tree to several targets, stored in an arena
+PathSet* buildPathSet(const int parent[], const int dist[], int src,
+                      const int targets[], int numTargets);
+void freePathSet(PathSet* set);
+
+// "A → B → C"; reversed prints from the far end back to the source
+int formatPath(Graph* g, const Path* p, int reversed, char* buf, int bufSize);
+
+#endif // PATH_H
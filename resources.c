@@ -1,6 +1,12 @@
 // --- FILE: resources.c ---
 #include "resources.h"
 #include "dijkstra.h"
+#include "donorfilter.h"
+#include "path.h"
+#include "distcache.h"
+#include "connectivity.h"
+#include "inventory.h"
+#include "spatial.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,14 +49,20 @@ void heapifyDown(PriorityQueue* pq, int idx) {
     }
 }
 
+// Silent insert; returns 0 when the queue is full
+int pushRequest(PriorityQueue* pq, CityRequest req) {
+    if (pq->size >= MAX_REQUESTS) return 0;
+    pq->requests[pq->size] = req;
+    heapifyUp(pq, pq->size);
+    pq->size++;
+    return 1;
+}
+
 void insertRequest(PriorityQueue* pq, CityRequest req) {
-    if (pq->size >= MAX_REQUESTS) {
+    if (!pushRequest(pq, req)) {
         printf("Queue full!\n");
         return;
     }
-    pq->requests[pq->size] = req;
-    heapifyUp(pq, pq->size);
-    pq->size++;
     printf("Added request: %s (Urgency %d, Need %d)\n",
            req.cityName, req.urgency, req.resourcesNeeded);
 }
@@ -72,9 +84,49 @@ HashMap* createHashMap() {
     HashMap* map = (HashMap*)malloc(sizeof(HashMap));
     for (int i = 0; i < HASH_SIZE; i++)
         map->buckets[i] = NULL;
+    poolInit(&map->entryPool, sizeof(HashEntry), HASH_ENTRIES_PER_CHUNK);
+    map->entries = NULL;
+    map->dirtySlots = NULL;
+    map->numEntries = 0;
+    map->numDirty = 0;
+    map->capacity = 0;
     return map;
 }
 
+// Queue an entry for the next status export (once per export)
+static void markDirty(HashMap* map, HashEntry* e) {
+    if (e->dirty) return;
+    e->dirty = 1;
+    map->dirtySlots[map->numDirty++] = e->slot;
+}
+
+// Give a new entry the next slot, growing the slot arrays as needed
+static void assignSlot(HashMap* map, HashEntry* e) {
+    if (map->numEntries == map->capacity) {
+        int cap = map->capacity ? map->capacity * 2 : HASH_ENTRIES_PER_CHUNK;
+        HashEntry** entries = (HashEntry**)realloc(map->entries, cap * sizeof(HashEntry*));
+        int* dirty = (int*)realloc(map->dirtySlots, cap * sizeof(int));
+        if (!entries || !dirty) {
+            fprintf(stderr, "HashMap memory failed\n");
+            exit(1);
+        }
+        map->entries = entries;
+        map->dirtySlots = dirty;
+        map->capacity = cap;
+    }
+    e->slot = map->numEntries;
+    e->dirty = 0;
+    map->entries[map->numEntries++] = e;
+    markDirty(map, e);
+}
+
+// Called by an exporter once the dirty slots have been written
+void clearDirtySlots(HashMap* map) {
+    for (int i = 0; i < map->numDirty; i++)
+        map->entries[map->dirtySlots[i]]->dirty = 0;
+    map->numDirty = 0;
+}
+
 unsigned int hashFunction(const char* str) {
     unsigned int hash = 0;
     while (*str)
@@ -82,31 +134,37 @@ unsigned int hashFunction(const char* str) {
     return hash % HASH_SIZE;
 }
 
-void insertHashEntry(HashMap* map, const char* cityName, Status status,
-                     int resources, const char* supportCity, int distance) {
+void insertHashEntry(HashMap* map, int cityId, const char* cityName, Status status,
+                     int resources, int donorId, const char* supportCity,
+                     int distance) {
     unsigned int idx = hashFunction(cityName);
     HashEntry* cur = map->buckets[idx];
     while (cur) {
         if (strcmp(cur->cityName, cityName) == 0) {
             cur->status = status;
             cur->resourcesAllocated = resources;
+            cur->donorId = donorId;
             strncpy(cur->supportCity, supportCity, MAX_NAME_LEN - 1);
             cur->distance = distance;
+            markDirty(map, cur);
             return;
         }
         cur = cur->next;
     }
 
-    HashEntry* entry = (HashEntry*)malloc(sizeof(HashEntry));
+    HashEntry* entry = (HashEntry*)poolAlloc(&map->entryPool);
+    entry->cityId = cityId;
     strncpy(entry->cityName, cityName, MAX_NAME_LEN - 1);
     entry->cityName[MAX_NAME_LEN - 1] = '\0';
     entry->status = status;
     entry->resourcesAllocated = resources;
+    entry->donorId = donorId;
     strncpy(entry->supportCity, supportCity, MAX_NAME_LEN - 1);
     entry->supportCity[MAX_NAME_LEN - 1] = '\0';
     entry->distance = distance;
     entry->next = map->buckets[idx];
     map->buckets[idx] = entry;
+    assignSlot(map, entry);
 }
 
 HashEntry* getHashEntry(HashMap* map, const char* cityName) {
@@ -120,69 +178,72 @@ HashEntry* getHashEntry(HashMap* map, const char* cityName) {
     return NULL;
 }
 
-void updateStatus(HashMap* map, const char* cityName, Status status) {
+const char* statusName(Status status) {
+    const char* s[] = {"PENDING", "IN_TRANSIT", "COMPLETED", "FAILED"};
+    return s[status];
+}
+
+// Silent status change; returns 0 if the city has no entry
+int setStatus(HashMap* map, const char* cityName, Status status) {
     HashEntry* e = getHashEntry(map, cityName);
-    if (e) {
-        e->status = status;
-        const char* s[] = {"PENDING", "IN_TRANSIT", "COMPLETED"};
-        printf("Status updated: %s → %s\n", cityName, s[status]);
-    }
+    if (!e) return 0;
+    e->status = status;
+    markDirty(map, e);
+    return 1;
+}
+
+void updateStatus(HashMap* map, const char* cityName, Status status) {
+    if (setStatus(map, cityName, status))
+        printf("Status updated: %s → %s\n", cityName, statusName(status));
 }
 
 void displayResourceStatus(HashMap* map) {
-    const char* s[] = {"PENDING", "IN_TRANSIT", "COMPLETED"};
     printf("\n------------------- RESOURCE STATUS -------------------\n\n");
 
-    int found = 0;
-    for (int i = 0; i < HASH_SIZE; i++) {
-        HashEntry* cur = map->buckets[i];
-        while (cur) {
-            found = 1;
-            printf("City: %-20s | Status: %-12s\n",
-                   cur->cityName, s[cur->status]);
-            printf("Resources: %d | Support: %s (%d km)\n",
-                   cur->resourcesAllocated, cur->supportCity, cur->distance);
-            printf("-------------------------------------------------------\n");
-            cur = cur->next;
-        }
+    // Slot order is insertion order; no need to walk every bucket
+    for (int i = 0; i < map->numEntries; i++) {
+        const HashEntry* cur = map->entries[i];
+        printf("City: %-20s | Status: %-12s\n",
+               cur->cityName, statusName(cur->status));
+        printf("Resources: %d | Support: %s (%d km)\n",
+               cur->resourcesAllocated, cur->supportCity, cur->distance);
+        printf("-------------------------------------------------------\n");
     }
-    if (!found)
+    if (map->numEntries == 0)
         printf("No allocations recorded yet.\n\n");
 }
 
 void freeHashMap(HashMap* map) {
-    for (int i = 0; i < HASH_SIZE; i++) {
-        HashEntry* cur = map->buckets[i];
-        while (cur) {
-            HashEntry* tmp = cur;
-            cur = cur->next;
-            free(tmp);
-        }
-    }
+    poolDestroy(&map->entryPool);
+    free(map->entries);
+    free(map->dirtySlots);
     free(map);
 }
 
 // --- Resource Allocation ---
-int findNearestSupportCity(Graph* g, int disasterCity, int need, int* distance) {
-    int dist[MAX_CITIES], parent[MAX_CITIES];
-    dijkstra(g, disasterCity, dist, parent);
-
-    int nearest = -1, minDist = INT_MAX;
-    for (int i = 0; i < g->numCities; i++) {
-        if (i != disasterCity &&
-            g->cities[i].availableResources >= need &&
-            g->cities[i].damageLevel < 3 &&
-            dist[i] < minDist) {
-            minDist = dist[i];
-            nearest = i;
-            printf("%s: dist=%d, res=%d, damage=%d\n",
-                   g->cities[i].name, dist[i],
-                   g->cities[i].availableResources,
-                   g->cities[i].damageLevel);
-        }
+// Restrict a city mask to the disaster city's component; 0 if nothing is left
+static int maskReachable(Graph* g, int city, unsigned int mask[]) {
+    unsigned int reach[CITY_MASK_WORDS];
+    componentMask(g, city, reach);
+    int any = 0;
+    for (int w = 0; w < CITY_MASK_WORDS; w++) {
+        mask[w] &= reach[w];
+        any |= mask[w] != 0;
     }
-    *distance = minDist;
-    return nearest;
+    return any;
+}
+
+// Eligible donors in the same component as a disaster city (no search)
+int countReachableDonors(Graph* g, int city) {
+    unsigned int eligible[CITY_MASK_WORDS];
+    DonorCriteria crit = { 1, 6, INF, city };
+    if (buildDonorMask(g, NULL, &crit, eligible) == 0 ||
+        !maskReachable(g, city, eligible))
+        return 0;
+    int count = 0;
+    for (int i = 0; i < g->numCities; i++)
+        count += CITY_MASK_TEST(eligible, i);
+    return count;
 }
 
 void logAllocation(const char* dCity, const char* sCity,
@@ -204,6 +265,147 @@ void logAllocation(const char* dCity, const char* sCity,
     fclose(fp);
 }
 
+// Drop excluded cities from a donor mask
+static void maskExclude(unsigned int mask[], const unsigned int exclude[]) {
+    if (!exclude) return;
+    for (int w = 0; w < CITY_MASK_WORDS; w++)
+        mask[w] &= ~exclude[w];
+}
+
+// Allocate one request from the nearest eligible donors (no I/O).
+// dist/parent receive the search tree from the disaster city; they are
+// left untouched when no eligible donor shares its component.
+int allocateRequest(Graph* g, const CityRequest* req, int dist[], int parent[],
+                    AllocationResult* out) {
+    return allocateFromDonors(g, req->cityId, req->resourcesNeeded, NULL,
+                              dist, parent, out);
+}
+
+// Spatial prefilter: do eligible donors within SUPPORT_SEARCH_RADIUS_KM
+// (great-circle) hold enough stock to cover amount on their own?
+static int nearbyStockCovers(Graph* g, int city, int amount, const unsigned int eligible[]) {
+    int ids[MAX_CITIES];
+    double km[MAX_CITIES];
+    int found = findCitiesWithinRadius(getSpatialIndex(g), g->cities.latitude[city],
+                                       g->cities.longitude[city], SUPPORT_SEARCH_RADIUS_KM,
+                                       ids, km, MAX_CITIES);
+    long stock = 0;
+    for (int k = 0; k < found; k++) {
+        if (!CITY_MASK_TEST(eligible, ids[k])) continue;
+        stock += g->cities.availableResources[ids[k]];
+        if (stock >= amount) return 1;
+    }
+    return 0;
+}
+
+// Dijkstra from city that stops once the eligible donors settled so far
+// hold amount units and nothing unsettled is as near as the last of them,
+// so the greedy below picks exactly what the full tree would. Fills order[]
+// with the settled donors; dist/parent are final for every settled city.
+static int settleNearestDonors(Graph* g, int city, int amount, const unsigned int eligible[],
+                               int dist[], int parent[], int order[]) {
+    int V = g->numCities, count = 0, coverDist = INF;
+    long stock = 0;
+    MinHeap* heap = createMinHeap(V);
+
+    for (int v = 0; v < V; v++) {
+        dist[v] = INF;
+        parent[v] = -1;
+        heap->array[v] = &heap->nodes[v];
+        heap->array[v]->vertex = v;
+        heap->array[v]->distance = INF;
+        heap->pos[v] = v;
+    }
+    heap->size = V;
+    dist[city] = 0;
+    decreaseKey(heap, city, 0);
+
+    while (!isEmpty(heap)) {
+        int u = extractMin(heap)->vertex;
+        if (dist[u] == INF || dist[u] > coverDist) break;
+
+        if (CITY_MASK_TEST(eligible, u)) {
+            order[count++] = u;
+            stock += g->cities.availableResources[u];
+            if (stock >= amount && coverDist == INF) coverDist = dist[u];
+        }
+        for (EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            int v = e->destCity;
+            if (e->distance < dist[v] - dist[u]) {
+                dist[v] = dist[u] + e->distance;
+                parent[v] = u;
+                decreaseKey(heap, v, dist[v]);
+            }
+        }
+    }
+    freeMinHeap(heap);
+    return count;
+}
+
+// Send up to amount units to city from the nearest eligible donors that
+// are not in exclude (may be NULL). With a ledger attached the units leave
+// the donors' stock as shipments; otherwise only the counts drop.
+// dist/parent are filled for the donors used and every city on their routes.
+int allocateFromDonors(Graph* g, int city, int amount, const unsigned int exclude[],
+                       int dist[], int parent[], AllocationResult* out) {
+    out->numDonors = 0;
+    out->total = 0;
+    out->remaining = amount;
+    out->farthest = 0;
+
+    unsigned int eligible[CITY_MASK_WORDS];
+    DonorCriteria crit = { 1, 6, INF, city };
+    buildDonorMask(g, NULL, &crit, eligible);
+    maskExclude(eligible, exclude);
+    if (amount <= 0 || !maskReachable(g, city, eligible))
+        return 0;
+
+    // A cached tree is reused as is. Otherwise, when donors close by can
+    // cover the request, a search that stops at them replaces the full tree.
+    int order[MAX_CITIES], count = 0;
+    int cached = probeShortestPaths(g, city, dist, parent);
+    if (!cached && nearbyStockCovers(g, city, amount, eligible)) {
+        count = settleNearestDonors(g, city, amount, eligible, dist, parent, order);
+    } else {
+        if (!cached) cachedDijkstra(g, city, dist, parent);
+        buildDonorMask(g, dist, &crit, eligible);
+        maskExclude(eligible, exclude);
+        for (int i = 0; i < g->numCities; i++)
+            if (CITY_MASK_TEST(eligible, i)) order[count++] = i;
+    }
+
+    // Insertion sort, nearest first (lower id on ties)
+    for (int j = 1; j < count; j++) {
+        int i = order[j], k = j;
+        while (k > 0 && (dist[order[k - 1]] > dist[i] ||
+                         (dist[order[k - 1]] == dist[i] && order[k - 1] > i))) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = i;
+    }
+
+    for (int k = 0; k < count && out->remaining > 0; k++) {
+        int i = order[k];
+        int give = (g->cities.availableResources[i] >= out->remaining)
+                   ? out->remaining : g->cities.availableResources[i];
+
+        if (g->inventory)
+            give = drawStock(g->inventory, i, city, give, dist[i]);
+        else if (give > 0)
+            g->cities.availableResources[i] -= give;
+        if (give <= 0) continue;
+
+        out->remaining -= give;
+        out->total += give;
+        out->donorIds[out->numDonors] = i;
+        out->sent[out->numDonors] = give;
+        out->numDonors++;
+        if (dist[i] > out->farthest) out->farthest = dist[i];
+    }
+    return out->numDonors;
+}
+
 void allocateResources(Graph* g, PriorityQueue* pq, HashMap* map) {
     if (isPQEmpty(pq)) {
         printf("\nNo pending requests.\n");
@@ -215,19 +417,11 @@ void allocateResources(Graph* g, PriorityQueue* pq, HashMap* map) {
            req.cityName, req.urgency, req.resourcesNeeded);
 
     int dist[MAX_CITIES], parent[MAX_CITIES];
-    dijkstra(g, req.cityId, dist, parent);
-
-    int remaining = req.resourcesNeeded, total = 0, donors = 0;
-    int order[MAX_CITIES];
-    for (int i = 0; i < g->numCities; i++) order[i] = i;
-
-    for (int i = 0; i < g->numCities - 1; i++)
-        for (int j = i + 1; j < g->numCities; j++)
-            if (dist[order[i]] > dist[order[j]]) {
-                int t = order[i];
-                order[i] = order[j];
-                order[j] = t;
-            }
+    AllocationResult res;
+    allocateRequest(g, &req, dist, parent, &res);
+    int remaining = res.remaining, total = res.total, donors = res.numDonors;
+    const int* donorIds = res.donorIds;
+    const int* sent = res.sent;
 
     FILE* fp = fopen("allocation_logs.txt", "a");
     time_t t = time(NULL);
@@ -239,36 +433,44 @@ void allocateResources(Graph* g, PriorityQueue* pq, HashMap* map) {
     fprintf(fp, "Timestamp: %s\nDisaster City: %s | Need: %d\n",
             timeStr, req.cityName, req.resourcesNeeded);
 
-    for (int k = 0; k < g->numCities && remaining > 0; k++) {
-        int i = order[k];
-        if (i == req.cityId || g->cities[i].damageLevel > 6 ||
-            g->cities[i].availableResources <= 0 || dist[i] == INF)
-            continue;
-
-        int give = (g->cities[i].availableResources >= remaining)
-                   ? remaining : g->cities[i].availableResources;
-
-        if (give <= 0) continue;
-
-        g->cities[i].availableResources -= give;
-        remaining -= give;
-        total += give;
-        donors++;
-
+    int left = req.resourcesNeeded;
+    for (int d = 0; d < donors; d++) {
+        int i = donorIds[d];
+        left -= sent[d];
         printf("Support: %s | Sent: %d | Dist: %d | Remain: %d\n",
-               g->cities[i].name, give, dist[i], remaining);
+               g->cities.name[i], sent[d], dist[i], left);
+    }
+
+    // Routes for every donor come from the one search tree above
+    PathSet* routes = buildPathSet(parent, dist, req.cityId, donorIds, donors);
+    char route[512];
+    int farthest = res.farthest;
+    for (int d = 0; d < donors; d++) {
+        int i = donorIds[d];
+        formatPath(g, &routes->paths[d], 1, route, sizeof(route));
         fprintf(fp, "Support: %s | Sent: %d | Dist: %d km\n",
-                g->cities[i].name, give, dist[i]);
+                g->cities.name[i], sent[d], dist[i]);
+        fprintf(fp, "Route: %s\n", route);
+    }
+    if (donors == 1) {
+        formatPath(g, &routes->paths[0], 1, route, sizeof(route));
+        printf("Route: %s\n", route);
     }
+    freePathSet(routes);
 
+    int donorId = (donors == 1) ? donorIds[0] : DONOR_MULTIPLE;
+    const char* support = (donors == 1) ? g->cities.name[donorId] : "Multiple";
+    if (donors == 0 && componentSize(g, req.cityId) < g->numCities)
+        printf("\n%s is cut off from every eligible donor.\n", req.cityName);
     if (remaining > 0) {
         printf("\nInsufficient resources. %d units still needed.\n", remaining);
-        insertHashEntry(map, req.cityName, FAILED, total,
-                        (donors > 0 ? "Partial" : "N/A"), 0);
+        insertHashEntry(map, req.cityId, req.cityName, FAILED, total, DONOR_NONE,
+                        (donors > 0 ? "Partial" : "N/A"), farthest);
         fprintf(fp, "Status: PARTIAL/FAILED (%d unfilled)\n", remaining);
     } else {
         printf("\nRequest fulfilled using %d support cities.\n", donors);
-        insertHashEntry(map, req.cityName, IN_TRANSIT, total, "Multiple", 0);
+        insertHashEntry(map, req.cityId, req.cityName, IN_TRANSIT, total, donorId,
+                        support, farthest);
         fprintf(fp, "Status: SUCCESS\n");
     }
 
@@ -3,9 +3,13 @@
 #define RESOURCES_H
 
 #include "graph.h"
+#include "allocator.h"
 
-#define MAX_REQUESTS 1000
-#define HASH_SIZE 5000
+#define HASH_ENTRIES_PER_CHUNK 128
+
+// Donor ids recorded for entries without a single support city
+#define DONOR_NONE -1               // "N/A" or "Partial"
+#define DONOR_MULTIPLE -2
 
 // Request status
 typedef enum {
@@ -18,6 +22,7 @@ typedef enum {
 
 // Disaster request
 typedef struct CityRequest {
+    int requestId;          // Caller-defined tag (-1 if unused)
     int cityId;
     char cityName[MAX_NAME_LEN];
     int urgency;            // 1–10 (10 = most urgent)
@@ -25,6 +30,16 @@ typedef struct CityRequest {
     Status status;
 } CityRequest;
 
+// Outcome of one allocation (donors nearest first)
+typedef struct AllocationResult {
+    int numDonors;
+    int donorIds[MAX_CITIES];
+    int sent[MAX_CITIES];
+    int total;
+    int remaining;
+    int farthest;           // km to the farthest donor used
+} AllocationResult;
+
 // Priority queue
 typedef struct PriorityQueue {
     CityRequest requests[MAX_REQUESTS];
@@ -33,21 +48,32 @@ typedef struct PriorityQueue {
 
 // Hash entry
 typedef struct HashEntry {
+    int cityId;
     char cityName[MAX_NAME_LEN];
     Status status;
     int resourcesAllocated;
+    int donorId;            // Support city, or DONOR_*
     char supportCity[MAX_NAME_LEN];
     int distance;
+    int slot;               // Position in insertion order (stable row id)
+    int dirty;              // Changed since the last export
     struct HashEntry* next;
 } HashEntry;
 
 // Hash map
 typedef struct HashMap {
     HashEntry* buckets[HASH_SIZE];
+    Pool entryPool;         // Backing store for all HashEntries
+    HashEntry** entries;    // Slot -> entry, so exports skip empty buckets
+    int* dirtySlots;        // Slots changed since the last export
+    int numEntries;
+    int numDirty;
+    int capacity;
 } HashMap;
 
 // Priority queue functions
 PriorityQueue* createPriorityQueue();
+int pushRequest(PriorityQueue* pq, CityRequest req);
 void insertRequest(PriorityQueue* pq, CityRequest req);
 CityRequest extractMostUrgent(PriorityQueue* pq);
 int isPQEmpty(PriorityQueue* pq);
@@ -57,17 +83,24 @@ void heapifyDown(PriorityQueue* pq, int idx);
 // Hash map functions
 HashMap* createHashMap();
 unsigned int hashFunction(const char* str);
-void insertHashEntry(HashMap* map, const char* cityName, Status status,
-                     int resources, const char* supportCity, int distance);
+void insertHashEntry(HashMap* map, int cityId, const char* cityName, Status status,
+                     int resources, int donorId, const char* supportCity,
+                     int distance);
 HashEntry* getHashEntry(HashMap* map, const char* cityName);
+int setStatus(HashMap* map, const char* cityName, Status status);
 void updateStatus(HashMap* map, const char* cityName, Status status);
+const char* statusName(Status status);
 void displayResourceStatus(HashMap* map);
+void clearDirtySlots(HashMap* map);
 void freeHashMap(HashMap* map);
 
 // Resource allocation
+int allocateRequest(Graph* g, const CityRequest* req, int dist[], int parent[],
+                    AllocationResult* out);
+int allocateFromDonors(Graph* g, int city, int amount, const unsigned int exclude[],
+                       int dist[], int parent[], AllocationResult* out);
 void allocateResources(Graph* g, PriorityQueue* pq, HashMap* map);
-int findNearestSupportCity(Graph* g, int disasterCity, int resourcesNeeded,
-                           int* distance);
+int countReachableDonors(Graph* g, int city);
 void logAllocation(const char* disasterCity, const char* supportCity,
                    int resources, int distance, const char* path);
 
@@ -0,0 +1,243 @@
+// --- FILE: scenario.c ---
+#include "scenario.h"
+#include "spatial.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+ScenarioConfig defaultScenarioConfig(void) {
+    ScenarioConfig cfg;
+    cfg.numScenarios = 1000;
+    cfg.seed = SIM_DEFAULT_SEED;
+    cfg.sim = defaultSimConfig();
+    cfg.sim.durationHours = 7 * 24;
+    cfg.epicentreDamageBoost = 4;
+    cfg.roadFailureProb = 0.3;
+    return cfg;
+}
+
+// Seed of scenario i: independent of thread count and run order
+unsigned long long scenarioSeed(unsigned long long masterSeed, int scenario) {
+    SimRng r;
+    seedRng(&r, masterSeed ^ ((unsigned long long)(scenario + 1) * 0x9E3779B97F4A7C15ULL));
+    return nextRandom(&r);
+}
+
+static int compareLong(const void* x, const void* y) {
+    long a = *(const long*)x, b = *(const long*)y;
+    return (a > b) - (a < b);
+}
+
+// Most critical first; ties broken deterministically
+static int compareRoads(const void* x, const void* y) {
+    const ScenarioRoad* a = (const ScenarioRoad*)x;
+    const ScenarioRoad* b = (const ScenarioRoad*)y;
+    if (a->impact != b->impact) return (a->impact < b->impact) ? 1 : -1;
+    if (a->failures != b->failures) return b->failures - a->failures;
+    if (a->src != b->src) return a->src - b->src;
+    return a->dest - b->dest;
+}
+
+// Nearest-rank percentile of a sorted array
+static long percentile(const long sorted[], int n, int pct) {
+    return sorted[(n * pct - 1) / 100];
+}
+
+// Damage field and road closures for one scenario, applied to a view.
+// Road keep (if >= 0) is left open but its draw still counts, so every
+// other closure and the simulation seed stay the same.
+static int applyScenario(Graph* v, const ScenarioConfig* cfg,
+                         const ScenarioRoad roads[], int numRoads,
+                         SimRng* rng, int keep, int failed[]) {
+    int n = v->numCities;
+    int epicentre = nextRange(rng, 0, n - 1);
+    double lat = v->cities.latitude[epicentre], lon = v->cities.longitude[epicentre];
+
+    for (int i = 0; i < n; i++) {
+        double km = greatCircleDistance(lat, lon, v->cities.latitude[i],
+                                        v->cities.longitude[i]);
+        int d = v->cities.damageLevel[i] + nextRange(rng, -1, 1) +
+                (int)(cfg->epicentreDamageBoost * exp(-km / DAMAGE_DECAY_KM) + 0.5);
+        v->cities.damageLevel[i] = d < 0 ? 0 : (d > 10 ? 10 : d);
+    }
+
+    // Roads between badly damaged cities fail more often
+    int numFailed = 0;
+    for (int r = 0; r < numRoads && numFailed < MAX_SCENARIO_FAILURES; r++) {
+        int a = roads[r].src, b = roads[r].dest;
+        double p = cfg->roadFailureProb *
+                   (v->cities.damageLevel[a] + v->cities.damageLevel[b]) / 20.0;
+        if (nextUniform(rng) < p) {
+            if (r != keep) closeRoad(v, a, b);
+            failed[numFailed++] = r;
+        }
+    }
+    return numFailed;
+}
+
+ScenarioSummary* runScenarios(const Graph* base, const ScenarioConfig* cfg) {
+    int n = cfg->numScenarios, nc = base->numCities;
+    ScenarioSummary* s = (ScenarioSummary*)calloc(1, sizeof(ScenarioSummary));
+    if (!s) {
+        fprintf(stderr, "Scenario memory failed\n");
+        exit(1);
+    }
+    s->numScenarios = n;
+    s->numCities = nc;
+    s->threads = 1;
+#ifdef _OPENMP
+    s->threads = omp_get_max_threads();
+#endif
+    if (n <= 0 || nc == 0) return s;
+
+    // Undirected roads of the base network
+    s->numRoads = collectRoads(base, NULL, NULL);
+    int* roadSrc = (int*)malloc((2 * s->numRoads + 1) * sizeof(int));
+    s->roads = (ScenarioRoad*)malloc((s->numRoads + 1) * sizeof(ScenarioRoad));
+    if (!roadSrc || !s->roads) {
+        fprintf(stderr, "Scenario memory failed\n");
+        exit(1);
+    }
+    int* roadDest = roadSrc + s->numRoads;
+    collectRoads(base, roadSrc, roadDest);
+    for (int r = 0; r < s->numRoads; r++) {
+        s->roads[r].src = roadSrc[r];
+        s->roads[r].dest = roadDest[r];
+        s->roads[r].failures = 0;
+        s->roads[r].impact = 0;
+    }
+    free(roadSrc);
+
+    long* cityUnmet = (long*)malloc((size_t)n * nc * sizeof(long));
+    long* totalUnmet = (long*)malloc(n * sizeof(long));
+    int* failed = (int*)malloc((size_t)n * MAX_SCENARIO_FAILURES * sizeof(int));
+    int* numFailed = (int*)malloc(n * sizeof(int));
+    long* extraUnmet = (long*)malloc((size_t)n * MAX_SCENARIO_FAILURES * sizeof(long));
+    if (!cityUnmet || !totalUnmet || !failed || !numFailed || !extraUnmet) {
+        fprintf(stderr, "Scenario memory failed\n");
+        exit(1);
+    }
+
+    // Scenarios are independent: each gets its own view, RNG stream and
+    // output slots, so results do not depend on scheduling
+    unsigned long events = 0;
+    double start = nowMs();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:events)
+#endif
+    for (int k = 0; k < n; k++) {
+        int* closed = &failed[k * MAX_SCENARIO_FAILURES];
+        SimRng rng;
+        seedRng(&rng, scenarioSeed(cfg->seed, k));
+
+        Graph* v = createGraphView(base);
+        numFailed[k] = applyScenario(v, cfg, s->roads, s->numRoads, &rng, -1, closed);
+
+        SimConfig sim = cfg->sim;
+        sim.seed = nextRandom(&rng);
+        SimReport rep;
+        runSimulationOn(v, &sim, &rep);
+        freeGraph(v);
+
+        memcpy(&cityUnmet[(size_t)k * nc], rep.unmetByCity, nc * sizeof(long));
+        totalUnmet[k] = rep.unitsUnmet;
+        events += rep.events;
+
+        // Paired runs: the same scenario with one closed road reopened
+        for (int f = 0; f < numFailed[k]; f++) {
+            int scratch[MAX_SCENARIO_FAILURES];
+            seedRng(&rng, scenarioSeed(cfg->seed, k));
+            v = createGraphView(base);
+            applyScenario(v, cfg, s->roads, s->numRoads, &rng, closed[f], scratch);
+            SimReport open;
+            runSimulationOn(v, &sim, &open);
+            freeGraph(v);
+            extraUnmet[k * MAX_SCENARIO_FAILURES + f] = rep.unitsUnmet - open.unitsUnmet;
+            events += open.events;
+        }
+    }
+    s->wallMs = nowMs() - start;
+    s->events = events;
+
+    double sumAll = 0;
+    for (int k = 0; k < n; k++) sumAll += totalUnmet[k];
+    s->meanUnmet = sumAll / n;
+
+    // Road criticality: mean extra unmet over the scenarios that closed it
+    for (int k = 0; k < n; k++) {
+        s->pairedRuns += numFailed[k];
+        for (int f = 0; f < numFailed[k]; f++) {
+            int r = failed[k * MAX_SCENARIO_FAILURES + f];
+            s->roads[r].failures++;
+            s->roads[r].impact += extraUnmet[k * MAX_SCENARIO_FAILURES + f];
+        }
+    }
+    for (int r = 0; r < s->numRoads; r++)
+        if (s->roads[r].failures > 0) s->roads[r].impact /= s->roads[r].failures;
+    qsort(s->roads, s->numRoads, sizeof(ScenarioRoad), compareRoads);
+
+    // Percentiles per city and of the scenario totals
+    long* column = (long*)malloc(n * sizeof(long));
+    if (!column) {
+        fprintf(stderr, "Scenario memory failed\n");
+        exit(1);
+    }
+    for (int i = 0; i < nc; i++) {
+        for (int k = 0; k < n; k++)
+            column[k] = cityUnmet[(size_t)k * nc + i];
+        qsort(column, n, sizeof(long), compareLong);
+        s->p50UnmetByCity[i] = percentile(column, n, 50);
+        s->p90UnmetByCity[i] = percentile(column, n, 90);
+        s->p99UnmetByCity[i] = percentile(column, n, 99);
+    }
+    qsort(totalUnmet, n, sizeof(long), compareLong);
+    s->p95Unmet = percentile(totalUnmet, n, 95);
+
+    free(column);
+    free(cityUnmet);
+    free(totalUnmet);
+    free(failed);
+    free(numFailed);
+    free(extraUnmet);
+    return s;
+}
+
+// Print summary
+void printScenarioSummary(const Graph* g, const ScenarioSummary* s) {
+    printf("\nScenarios: %d | Threads: %d | Wall time: %.1f ms | %.0f scenarios/s\n",
+           s->numScenarios, s->threads, s->wallMs,
+           s->wallMs > 0 ? s->numScenarios * 1000.0 / s->wallMs : 0);
+    printf("Simulated events: %lu | Paired re-runs: %ld\n", s->events, s->pairedRuns);
+    printf("Unmet demand per scenario: mean %.0f | p95 %ld units\n",
+           s->meanUnmet, s->p95Unmet);
+
+    printf("\n%-15s %8s %8s %8s\n", "City", "p50", "p90", "p99");
+    for (int i = 0; i < s->numCities && i < g->numCities; i++)
+        printf("%-15s %8ld %8ld %8ld\n", g->cities.name[i], s->p50UnmetByCity[i],
+               s->p90UnmetByCity[i], s->p99UnmetByCity[i]);
+
+    printf("\nMost critical roads (extra unmet units vs. the same scenario with it open):\n");
+    int shown = 0;
+    for (int r = 0; r < s->numRoads && shown < CRITICAL_ROADS_SHOWN; r++) {
+        const ScenarioRoad* road = &s->roads[r];
+        if (road->failures == 0 || road->impact <= 0) continue;
+        printf("  %s ↔ %s | +%.0f units | closed in %d scenarios\n",
+               g->cities.name[road->src], g->cities.name[road->dest],
+               road->impact, road->failures);
+        shown++;
+    }
+    if (shown == 0)
+        printf("  No road closure increased unmet demand.\n");
+}
+
+void freeScenarioSummary(ScenarioSummary* s) {
+    if (!s) return;
+    free(s->roads);
+    free(s);
+}
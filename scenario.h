@@ -0,0 +1,53 @@
+// --- FILE: scenario.h ---
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "graph.h"
+#include "simulation.h"
+
+#define MAX_SCENARIO_FAILURES 8     // Road closures per scenario
+#define DAMAGE_DECAY_KM 60.0        // Damage boost halves roughly every 40 km
+#define CRITICAL_ROADS_SHOWN 5
+
+// Monte Carlo parameters
+typedef struct ScenarioConfig {
+    int numScenarios;
+    unsigned long long seed;        // Master seed; scenario i derives its own
+    SimConfig sim;                  // Template for every run (seed overwritten)
+    int epicentreDamageBoost;       // Added at the epicentre, decays with distance
+    double roadFailureProb;         // For a road between two cities at damage 10
+} ScenarioConfig;
+
+// Undirected road of the base graph
+typedef struct ScenarioRoad {
+    int src;
+    int dest;
+    int failures;                   // Scenarios in which it was closed
+    double impact;                  // Mean extra unmet vs. the same scenario with it open
+} ScenarioRoad;
+
+// Aggregated results
+typedef struct ScenarioSummary {
+    int numScenarios;
+    int numCities;
+    int threads;
+    double wallMs;
+    unsigned long events;           // Including paired re-runs
+    long pairedRuns;                // Re-runs with one closed road reopened
+    double meanUnmet;               // Total units unmet per scenario
+    long p95Unmet;
+    long p50UnmetByCity[MAX_CITIES];
+    long p90UnmetByCity[MAX_CITIES];
+    long p99UnmetByCity[MAX_CITIES];
+    int numRoads;
+    ScenarioRoad* roads;            // Sorted by impact, most critical first
+} ScenarioSummary;
+
+// Monte Carlo runner
+ScenarioConfig defaultScenarioConfig(void);
+unsigned long long scenarioSeed(unsigned long long masterSeed, int scenario);
+ScenarioSummary* runScenarios(const Graph* base, const ScenarioConfig* cfg);
+void printScenarioSummary(const Graph* g, const ScenarioSummary* s);
+void freeScenarioSummary(ScenarioSummary* s);
+
+#endif // SCENARIO_H
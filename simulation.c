@@ -0,0 +1,365 @@
+// --- FILE: simulation.c ---
+#include "simulation.h"
+#include "timeroute.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// --- Random numbers (splitmix64 seeding, xorshift64* stream) ---
+void seedRng(SimRng* r, unsigned long long seed) {
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    r->state = (z ^ (z >> 31)) | 1;
+}
+
+unsigned long long nextRandom(SimRng* r) {
+    r->state ^= r->state >> 12;
+    r->state ^= r->state << 25;
+    r->state ^= r->state >> 27;
+    return r->state * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform in [0, 1)
+double nextUniform(SimRng* r) {
+    return (double)(nextRandom(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform integer in [lo, hi]
+int nextRange(SimRng* r, int lo, int hi) {
+    return lo + (int)(nextRandom(r) % (unsigned long long)(hi - lo + 1));
+}
+
+// --- Event Calendar ---
+static int eventBefore(const SimEvent* x, const SimEvent* y) {
+    if (x->time != y->time) return x->time < y->time;
+    if (x->kind != y->kind) return x->kind < y->kind;
+    return x->seq < y->seq;
+}
+
+void initCalendar(EventCalendar* cal) {
+    cal->size = 0;
+    cal->capacity = SIM_INITIAL_EVENTS;
+    cal->nextSeq = 0;
+    cal->events = (SimEvent*)malloc(cal->capacity * sizeof(SimEvent));
+    if (!cal->events) {
+        fprintf(stderr, "Event calendar memory failed\n");
+        exit(1);
+    }
+}
+
+void scheduleEvent(EventCalendar* cal, long time, SimEventKind kind, int a, int b) {
+    if (cal->size == cal->capacity) {
+        cal->capacity *= 2;
+        cal->events = (SimEvent*)realloc(cal->events, cal->capacity * sizeof(SimEvent));
+        if (!cal->events) {
+            fprintf(stderr, "Event calendar memory failed\n");
+            exit(1);
+        }
+    }
+
+    SimEvent ev = { time, cal->nextSeq++, kind, a, b };
+    int i = cal->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!eventBefore(&ev, &cal->events[parent])) break;
+        cal->events[i] = cal->events[parent];
+        i = parent;
+    }
+    cal->events[i] = ev;
+}
+
+// Pop the earliest event; returns 0 when the calendar is empty
+int nextEvent(EventCalendar* cal, SimEvent* out) {
+    if (cal->size == 0) return 0;
+    *out = cal->events[0];
+
+    SimEvent last = cal->events[--cal->size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= cal->size) break;
+        if (child + 1 < cal->size &&
+            eventBefore(&cal->events[child + 1], &cal->events[child]))
+            child++;
+        if (!eventBefore(&cal->events[child], &last)) break;
+        cal->events[i] = cal->events[child];
+        i = child;
+    }
+    if (cal->size > 0)
+        cal->events[i] = last;
+    return 1;
+}
+
+void freeCalendar(EventCalendar* cal) {
+    free(cal->events);
+    cal->events = NULL;
+    cal->size = cal->capacity = 0;
+}
+
+// --- Simulation ---
+// Per-request bookkeeping
+typedef struct SimRequest {
+    int cityId;
+    int need;
+    long created;
+    int outstanding;        // Convoys still on the road
+    int shortfall;          // Units no donor could cover
+} SimRequest;
+
+SimConfig defaultSimConfig(void) {
+    SimConfig cfg;
+    cfg.seed = SIM_DEFAULT_SEED;
+    cfg.durationHours = 30 * 24;
+    cfg.meanInterarrivalHours = 6;
+    cfg.minNeed = 50;
+    cfg.maxNeed = 400;
+    cfg.dispatchIntervalHours = 2;
+    cfg.replenishIntervalHours = 24;
+    cfg.replenishUnits = 40;
+    cfg.speedKmph = FREE_FLOW_SPEED_KMPH;
+    cfg.vehicle = VEHICLE_TRUCK;
+    return cfg;
+}
+
+static long hoursToMinutes(double hours) {
+    long m = (long)(hours * 60.0 + 0.5);
+    return m > 0 ? m : 1;
+}
+
+static int compareLong(const void* x, const void* y) {
+    long a = *(const long*)x, b = *(const long*)y;
+    return (a > b) - (a < b);
+}
+
+// Run on a graph the caller owns; its city stock is consumed
+void runSimulationOn(Graph* g, const SimConfig* cfg, SimReport* report) {
+    memset(report, 0, sizeof(SimReport));
+    if (g->numCities == 0) return;
+
+    PriorityQueue* pq = createPriorityQueue();
+    HashMap* map = createHashMap();
+    EventCalendar cal;
+    initCalendar(&cal);
+    SimRng rng;
+    seedRng(&rng, cfg->seed);
+
+    // Disasters strike damaged cities more often (weight = damage + 1)
+    int weight[MAX_CITIES], totalWeight = 0;
+    for (int i = 0; i < g->numCities; i++) {
+        totalWeight += g->cities.damageLevel[i] + 1;
+        weight[i] = totalWeight;
+    }
+
+    int capacity = 1024, numRequests = 0;
+    SimRequest* reqs = (SimRequest*)malloc(capacity * sizeof(SimRequest));
+    long* latency = (long*)malloc(capacity * sizeof(long));
+    if (!reqs || !latency) {
+        fprintf(stderr, "Simulation memory failed\n");
+        exit(1);
+    }
+    int numLatencies = 0;
+
+    long end = hoursToMinutes(cfg->durationHours);
+    long dispatchEvery = hoursToMinutes(cfg->dispatchIntervalHours);
+    long replenishEvery = hoursToMinutes(cfg->replenishIntervalHours);
+    double meanGap = cfg->meanInterarrivalHours * 60.0;
+
+    scheduleEvent(&cal, 0, SIM_DISASTER, 0, 0);
+    scheduleEvent(&cal, dispatchEvery, SIM_DISPATCH, 0, 0);
+    if (cfg->replenishUnits > 0)
+        scheduleEvent(&cal, replenishEvery, SIM_REPLENISH, 0, 0);
+
+    int dist[MAX_CITIES], parent[MAX_CITIES];
+    int legal[MAX_CITIES], legalParent[MAX_CITIES];
+    double start = nowMs();
+    SimEvent ev;
+
+    while (nextEvent(&cal, &ev)) {
+        report->events++;
+
+        switch (ev.kind) {
+            case SIM_DISASTER: {
+                int r = nextRange(&rng, 0, totalWeight - 1);
+                int lo = 0, hi = g->numCities - 1;
+                while (lo < hi) {
+                    int mid = (lo + hi) / 2;
+                    if (weight[mid] > r) hi = mid;
+                    else lo = mid + 1;
+                }
+
+                if (numRequests == capacity) {
+                    capacity *= 2;
+                    reqs = (SimRequest*)realloc(reqs, capacity * sizeof(SimRequest));
+                    latency = (long*)realloc(latency, capacity * sizeof(long));
+                    if (!reqs || !latency) {
+                        fprintf(stderr, "Simulation memory failed\n");
+                        exit(1);
+                    }
+                }
+                SimRequest* sr = &reqs[numRequests];
+                sr->cityId = lo;
+                sr->need = nextRange(&rng, cfg->minNeed, cfg->maxNeed);
+                sr->created = ev.time;
+                sr->outstanding = 0;
+                sr->shortfall = 0;
+
+                CityRequest req;
+                req.requestId = numRequests;
+                req.cityId = lo;
+                strncpy(req.cityName, g->cities.name[lo], MAX_NAME_LEN - 1);
+                req.cityName[MAX_NAME_LEN - 1] = '\0';
+                req.urgency = g->cities.damageLevel[lo] + nextRange(&rng, -1, 1);
+                if (req.urgency < 1) req.urgency = 1;
+                if (req.urgency > 10) req.urgency = 10;
+                req.resourcesNeeded = sr->need;
+                req.status = PENDING;
+
+                report->requests++;
+                report->unitsRequested += sr->need;
+                if (pushRequest(pq, req)) {
+                    insertHashEntry(map, req.cityId, req.cityName, PENDING, 0,
+                                    DONOR_NONE, "N/A", 0);
+                } else {
+                    report->failed++;
+                    report->unitsUnmet += sr->need;
+                    report->unmetByCity[lo] += sr->need;
+                }
+                numRequests++;
+
+                long gap = (long)(-log(1.0 - nextUniform(&rng)) * meanGap + 0.5);
+                if (ev.time + gap < end)
+                    scheduleEvent(&cal, ev.time + (gap > 0 ? gap : 1), SIM_DISASTER, 0, 0);
+                break;
+            }
+
+            case SIM_DISPATCH: {
+                while (!isPQEmpty(pq)) {
+                    CityRequest req = extractMostUrgent(pq);
+                    SimRequest* sr = &reqs[req.requestId];
+                    AllocationResult res;
+                    allocateRequest(g, &req, dist, parent, &res);
+
+                    sr->shortfall = res.remaining;
+                    report->unitsUnmet += res.remaining;
+                    report->unmetByCity[req.cityId] += res.remaining;
+                    if (res.numDonors == 0) {
+                        report->failed++;
+                        setStatus(map, req.cityName, FAILED);
+                        continue;
+                    }
+
+                    // One convoy per donor over roads open to its class and
+                    // load; travel time from road distance. Units with no
+                    // legal route stay with the donor and count as unmet.
+                    sr->outstanding = 0;
+                    for (int d = 0; d < res.numDonors; d++) {
+                        int donor = res.donorIds[d], units = res.sent[d];
+                        long km = dist[donor];
+                        if (!pathAllows(g, dist, parent, donor, cfg->vehicle, units)) {
+                            dijkstraForVehicle(g, req.cityId, cfg->vehicle, units,
+                                               legal, legalParent);
+                            km = legal[donor];
+                        }
+                        if (km == INF) {
+                            g->cities.availableResources[donor] += units;
+                            sr->shortfall += units;
+                            report->unitsUnmet += units;
+                            report->unmetByCity[req.cityId] += units;
+                            continue;
+                        }
+                        long travel = (km * 60 + cfg->speedKmph - 1) / cfg->speedKmph;
+                        scheduleEvent(&cal, ev.time + (travel > 0 ? travel : 1),
+                                      SIM_CONVOY_ARRIVAL, req.requestId, units);
+                        sr->outstanding++;
+                    }
+                    if (sr->outstanding == 0) {
+                        report->failed++;
+                        setStatus(map, req.cityName, FAILED);
+                        continue;
+                    }
+                    setStatus(map, req.cityName, IN_TRANSIT);
+                }
+                if (ev.time + dispatchEvery <= end)
+                    scheduleEvent(&cal, ev.time + dispatchEvery, SIM_DISPATCH, 0, 0);
+                break;
+            }
+
+            case SIM_CONVOY_ARRIVAL: {
+                SimRequest* sr = &reqs[ev.a];
+                report->unitsDelivered += ev.b;
+                if (--sr->outstanding > 0) break;
+
+                latency[numLatencies++] = ev.time - sr->created;
+                if (sr->shortfall == 0) {
+                    report->fulfilled++;
+                    setStatus(map, g->cities.name[sr->cityId], COMPLETED);
+                } else {
+                    report->partial++;
+                    setStatus(map, g->cities.name[sr->cityId], FAILED);
+                }
+                break;
+            }
+
+            case SIM_REPLENISH:
+                for (int i = 0; i < g->numCities; i++)
+                    g->cities.availableResources[i] += cfg->replenishUnits;
+                if (ev.time + replenishEvery < end)
+                    scheduleEvent(&cal, ev.time + replenishEvery, SIM_REPLENISH, 0, 0);
+                break;
+        }
+    }
+
+    // Requests still queued when the horizon closed went unserved
+    while (!isPQEmpty(pq)) {
+        CityRequest req = extractMostUrgent(pq);
+        report->failed++;
+        report->unitsUnmet += req.resourcesNeeded;
+        report->unmetByCity[req.cityId] += req.resourcesNeeded;
+    }
+
+    report->wallMs = nowMs() - start;
+    report->eventsPerSec = report->wallMs > 0
+                           ? report->events * 1000.0 / report->wallMs : 0;
+
+    if (numLatencies > 0) {
+        qsort(latency, numLatencies, sizeof(long), compareLong);
+        double sum = 0;
+        for (int i = 0; i < numLatencies; i++) sum += latency[i];
+        report->meanLatencyHours = sum / numLatencies / 60.0;
+        report->p95LatencyHours = latency[(numLatencies * 95 - 1) / 100] / 60.0;
+        report->maxLatencyHours = latency[numLatencies - 1] / 60.0;
+    }
+
+    free(reqs);
+    free(latency);
+    freeCalendar(&cal);
+    freeHashMap(map);
+    free(pq);
+}
+
+void runSimulation(const Graph* base, const SimConfig* cfg, SimReport* report) {
+    Graph* g = createGraphView(base);
+    runSimulationOn(g, cfg, report);
+    freeGraph(g);
+}
+
+// Print a report
+void printSimReport(const Graph* g, const SimReport* r) {
+    printf("\nSimulated events: %lu | Wall time: %.1f ms | %.0f events/s\n",
+           r->events, r->wallMs, r->eventsPerSec);
+    printf("Requests: %d | Fulfilled: %d | Partial: %d | Failed: %d\n",
+           r->requests, r->fulfilled, r->partial, r->failed);
+    printf("Units requested: %ld | Delivered: %ld | Unmet: %ld\n",
+           r->unitsRequested, r->unitsDelivered, r->unitsUnmet);
+    printf("Fulfilment latency: mean %.1f h | p95 %.1f h | max %.1f h\n",
+           r->meanLatencyHours, r->p95LatencyHours, r->maxLatencyHours);
+
+    if (r->unitsUnmet == 0) return;
+    printf("\nUnmet demand by city:\n");
+    for (int i = 0; i < g->numCities; i++)
+        if (r->unmetByCity[i] > 0)
+            printf("  %-15s %ld units\n", g->cities.name[i], r->unmetByCity[i]);
+}
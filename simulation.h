@@ -0,0 +1,91 @@
+// --- FILE: simulation.h ---
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "graph.h"
+#include "resources.h"
+
+#define SIM_DEFAULT_SEED 2024
+#define SIM_INITIAL_EVENTS 256
+
+// Event kinds, in tie-break order for events at the same minute
+typedef enum {
+    SIM_REPLENISH,
+    SIM_CONVOY_ARRIVAL,
+    SIM_DISASTER,
+    SIM_DISPATCH
+} SimEventKind;
+
+// Calendar entry; (time, kind, seq) gives a total, reproducible order
+typedef struct SimEvent {
+    long time;              // Simulated minutes since start
+    unsigned long seq;
+    SimEventKind kind;
+    int a;                  // Request index (arrival) / unused
+    int b;                  // Units carried (arrival) / unused
+} SimEvent;
+
+// Binary min-heap event calendar
+typedef struct EventCalendar {
+    SimEvent* events;
+    int size;
+    int capacity;
+    unsigned long nextSeq;
+} EventCalendar;
+
+// Scenario parameters (times in hours)
+typedef struct SimConfig {
+    unsigned long long seed;
+    double durationHours;
+    double meanInterarrivalHours;   // Between disaster requests
+    int minNeed;
+    int maxNeed;
+    double dispatchIntervalHours;   // How often the queue is drained
+    double replenishIntervalHours;
+    int replenishUnits;             // Added to every city per replenishment
+    int speedKmph;                  // Convoy speed
+    VehicleClass vehicle;           // Convoy class (road restrictions)
+} SimConfig;
+
+// Aggregate outcome of one run
+typedef struct SimReport {
+    unsigned long events;
+    double wallMs;
+    double eventsPerSec;
+    int requests;
+    int fulfilled;
+    int partial;
+    int failed;                     // Nothing sent, or queue full
+    long unitsRequested;
+    long unitsDelivered;
+    long unitsUnmet;
+    double meanLatencyHours;        // Request to last convoy arrival
+    double p95LatencyHours;
+    double maxLatencyHours;
+    long unmetByCity[MAX_CITIES];
+} SimReport;
+
+// Seeded random stream (same seed, same sequence on every platform)
+typedef struct SimRng {
+    unsigned long long state;
+} SimRng;
+
+// Random numbers
+void seedRng(SimRng* r, unsigned long long seed);
+unsigned long long nextRandom(SimRng* r);
+double nextUniform(SimRng* r);
+int nextRange(SimRng* r, int lo, int hi);
+
+// Event calendar
+void initCalendar(EventCalendar* cal);
+void scheduleEvent(EventCalendar* cal, long time, SimEventKind kind, int a, int b);
+int nextEvent(EventCalendar* cal, SimEvent* out);
+void freeCalendar(EventCalendar* cal);
+
+// Simulation (runSimulation works on a copy-on-write view; the base is untouched)
+SimConfig defaultSimConfig(void);
+void runSimulation(const Graph* base, const SimConfig* cfg, SimReport* report);
+void runSimulationOn(Graph* g, const SimConfig* cfg, SimReport* report);
+void printSimReport(const Graph* g, const SimReport* report);
+
+#endif // SIMULATION_H
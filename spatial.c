@@ -0,0 +1,283 @@
+// --- FILE: spatial.c ---
+#include "spatial.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Convert lat/lon (degrees) to a unit vector
+static void toUnitVector(double lat, double lon, double out[3]) {
+    double phi = lat * M_PI / 180.0;
+    double lambda = lon * M_PI / 180.0;
+    out[0] = cos(phi) * cos(lambda);
+    out[1] = cos(phi) * sin(lambda);
+    out[2] = sin(phi);
+}
+
+// Squared chord length between unit vectors
+static double chordSq(const double a[3], const double b[3]) {
+    double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Chord length -> great-circle km
+static double chordToKm(double chord) {
+    double half = chord / 2.0;
+    if (half > 1.0) half = 1.0;
+    return 2.0 * EARTH_RADIUS_KM * asin(half);
+}
+
+// Great-circle km -> chord length
+static double kmToChord(double km) {
+    double angle = km / EARTH_RADIUS_KM;
+    if (angle >= M_PI) return 2.0;
+    return 2.0 * sin(angle / 2.0);
+}
+
+// Haversine distance in km
+double greatCircleDistance(double lat1, double lon1, double lat2, double lon2) {
+    double a[3], b[3];
+    toUnitVector(lat1, lon1, a);
+    toUnitVector(lat2, lon2, b);
+    return chordToKm(sqrt(chordSq(a, b)));
+}
+
+// Swap two entries in tree order
+static void swapEntries(SpatialIndex* idx, int i, int j) {
+    int id = idx->cityIds[i];
+    idx->cityIds[i] = idx->cityIds[j];
+    idx->cityIds[j] = id;
+    for (int d = 0; d < 3; d++) {
+        double t = idx->points[i][d];
+        idx->points[i][d] = idx->points[j][d];
+        idx->points[j][d] = t;
+    }
+}
+
+// Quickselect so that position k holds the median along axis
+static void selectAxis(SpatialIndex* idx, int lo, int hi, int k, int axis) {
+    while (hi - lo > 1) {
+        double pivot = idx->points[(lo + hi) / 2][axis];
+        int i = lo, j = hi - 1;
+        while (i <= j) {
+            while (idx->points[i][axis] < pivot) i++;
+            while (idx->points[j][axis] > pivot) j--;
+            if (i <= j) {
+                swapEntries(idx, i, j);
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) hi = j + 1;
+        else if (k >= i) lo = i;
+        else return;
+    }
+}
+
+// Build implicit k-d tree over [lo, hi)
+static void buildRange(SpatialIndex* idx, int lo, int hi, int depth) {
+    if (hi - lo <= 1) return;
+    int mid = (lo + hi) / 2;
+    selectAxis(idx, lo, hi, mid, depth % 3);
+    buildRange(idx, lo, mid, depth + 1);
+    buildRange(idx, mid + 1, hi, depth + 1);
+}
+
+// Load unit vectors for n points and build the tree
+static void loadPoints(SpatialIndex* idx, const double lat[], const double lon[], int n) {
+    free(idx->cityIds);
+    free(idx->points);
+    idx->cityIds = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    idx->points = (double (*)[3])malloc((n > 0 ? n : 1) * sizeof(*idx->points));
+    if (!idx->cityIds || !idx->points) {
+        fprintf(stderr, "Spatial index memory failed\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < n; i++) {
+        idx->cityIds[i] = i;
+        toUnitVector(lat[i], lon[i], idx->points[i]);
+    }
+    idx->size = n;
+    buildRange(idx, 0, n, 0);
+}
+
+// Create index over raw coordinates (ids are array positions)
+SpatialIndex* createSpatialIndexFromPoints(const double lat[], const double lon[], int n) {
+    SpatialIndex* idx = (SpatialIndex*)malloc(sizeof(SpatialIndex));
+    if (!idx) {
+        fprintf(stderr, "Spatial index memory failed\n");
+        exit(1);
+    }
+    idx->size = 0;
+    idx->cityIds = NULL;
+    idx->points = NULL;
+    loadPoints(idx, lat, lon, n);
+    return idx;
+}
+
+// Create index
+SpatialIndex* createSpatialIndex(Graph* g) {
+    return createSpatialIndexFromPoints(g->cities.latitude, g->cities.longitude, g->numCities);
+}
+
+// Rebuild index from current cities
+void rebuildSpatialIndex(SpatialIndex* idx, Graph* g) {
+    loadPoints(idx, g->cities.latitude, g->cities.longitude, g->numCities);
+}
+
+// Free index
+void freeSpatialIndex(SpatialIndex* idx) {
+    if (!idx) return;
+    free(idx->cityIds);
+    free(idx->points);
+    free(idx);
+}
+
+// --- k-nearest search ---
+typedef struct {
+    int k;
+    int count;
+    int* ids;
+    double* distSq;         // Sorted ascending
+} KnnState;
+
+static void knnOffer(KnnState* s, int id, double dSq) {
+    if (s->count == s->k && dSq >= s->distSq[s->count - 1]) return;
+
+    int i = (s->count < s->k) ? s->count++ : s->count - 1;
+    while (i > 0 && s->distSq[i - 1] > dSq) {
+        s->ids[i] = s->ids[i - 1];
+        s->distSq[i] = s->distSq[i - 1];
+        i--;
+    }
+    s->ids[i] = id;
+    s->distSq[i] = dSq;
+}
+
+static void knnSearch(SpatialIndex* idx, int lo, int hi, int depth,
+                      const double q[3], KnnState* s) {
+    if (lo >= hi) return;
+    int mid = (lo + hi) / 2;
+    int axis = depth % 3;
+
+    knnOffer(s, idx->cityIds[mid], chordSq(q, idx->points[mid]));
+
+    double diff = q[axis] - idx->points[mid][axis];
+    if (diff < 0) {
+        knnSearch(idx, lo, mid, depth + 1, q, s);
+        if (s->count < s->k || diff * diff < s->distSq[s->count - 1])
+            knnSearch(idx, mid + 1, hi, depth + 1, q, s);
+    } else {
+        knnSearch(idx, mid + 1, hi, depth + 1, q, s);
+        if (s->count < s->k || diff * diff < s->distSq[s->count - 1])
+            knnSearch(idx, lo, mid, depth + 1, q, s);
+    }
+}
+
+// Find k nearest cities to a coordinate
+int findKNearestCities(SpatialIndex* idx, double lat, double lon, int k,
+                       int outIds[], double outKm[]) {
+    if (k <= 0 || idx->size == 0) return 0;
+    if (k > idx->size) k = idx->size;
+
+    double q[3];
+    toUnitVector(lat, lon, q);
+
+    KnnState s;
+    s.k = k;
+    s.count = 0;
+    s.ids = outIds;
+    s.distSq = outKm;
+    knnSearch(idx, 0, idx->size, 0, q, &s);
+
+    for (int i = 0; i < s.count; i++)
+        outKm[i] = chordToKm(sqrt(outKm[i]));
+    return s.count;
+}
+
+// --- Radius search ---
+typedef struct {
+    double limitSq;
+    int count;
+    int maxOut;
+    int* ids;
+    double* distSq;
+} RadiusState;
+
+static void radiusSearch(SpatialIndex* idx, int lo, int hi, int depth,
+                         const double q[3], RadiusState* s) {
+    if (lo >= hi || s->count >= s->maxOut) return;
+    int mid = (lo + hi) / 2;
+    int axis = depth % 3;
+
+    double dSq = chordSq(q, idx->points[mid]);
+    if (dSq <= s->limitSq) {
+        s->ids[s->count] = idx->cityIds[mid];
+        s->distSq[s->count] = dSq;
+        s->count++;
+    }
+
+    double diff = q[axis] - idx->points[mid][axis];
+    if (diff < 0 || diff * diff <= s->limitSq)
+        radiusSearch(idx, lo, mid, depth + 1, q, s);
+    if (diff >= 0 || diff * diff <= s->limitSq)
+        radiusSearch(idx, mid + 1, hi, depth + 1, q, s);
+}
+
+// Find all cities within radius (km)
+int findCitiesWithinRadius(SpatialIndex* idx, double lat, double lon,
+                           double radiusKm, int outIds[], double outKm[],
+                           int maxOut) {
+    if (maxOut <= 0 || idx->size == 0 || radiusKm < 0) return 0;
+
+    double q[3];
+    toUnitVector(lat, lon, q);
+    double chord = kmToChord(radiusKm);
+
+    RadiusState s;
+    s.limitSq = chord * chord;
+    s.count = 0;
+    s.maxOut = maxOut;
+    s.ids = outIds;
+    s.distSq = outKm;
+    radiusSearch(idx, 0, idx->size, 0, q, &s);
+
+    // Insertion sort: result sets are small
+    for (int i = 1; i < s.count; i++) {
+        int id = outIds[i];
+        double d = outKm[i];
+        int j = i - 1;
+        while (j >= 0 && outKm[j] > d) {
+            outIds[j + 1] = outIds[j];
+            outKm[j + 1] = outKm[j];
+            j--;
+        }
+        outIds[j + 1] = id;
+        outKm[j + 1] = d;
+    }
+    for (int i = 0; i < s.count; i++)
+        outKm[i] = chordToKm(sqrt(outKm[i]));
+    return s.count;
+}
+
+// Snap a coordinate to the nearest graph node
+int snapToNearestCity(SpatialIndex* idx, double lat, double lon, double* km) {
+    int id;
+    double d;
+    if (findKNearestCities(idx, lat, lon, 1, &id, &d) == 0) return -1;
+    if (km) *km = d;
+    return id;
+}
+
+// Lazily (re)built index owned by the graph
+SpatialIndex* getSpatialIndex(Graph* g) {
+    if (!g->spatialIndex)
+        g->spatialIndex = createSpatialIndex(g);
+    else if (g->spatialIndex->size != g->numCities)
+        rebuildSpatialIndex(g->spatialIndex, g);
+    return g->spatialIndex;
+}
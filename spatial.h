@@ -0,0 +1,39 @@
+// --- FILE: spatial.h ---
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include "graph.h"
+
+#define EARTH_RADIUS_KM 6371.0
+
+// Donor prefilter radius used before the road-distance search
+#define SUPPORT_SEARCH_RADIUS_KM 300.0
+
+// Static k-d tree over city positions.
+// Cities are stored as unit vectors on the sphere, so chord distance
+// orders points exactly like great-circle distance (no dateline issues).
+typedef struct SpatialIndex {
+    int size;
+    int* cityIds;           // Tree order (implicit, median at range midpoint)
+    double (*points)[3];    // Unit vectors in tree order
+} SpatialIndex;
+
+// Index lifecycle
+SpatialIndex* createSpatialIndex(Graph* g);
+SpatialIndex* createSpatialIndexFromPoints(const double lat[], const double lon[], int n);
+void rebuildSpatialIndex(SpatialIndex* idx, Graph* g);
+void freeSpatialIndex(SpatialIndex* idx);
+SpatialIndex* getSpatialIndex(Graph* g);
+
+// Queries (results sorted by ascending great-circle distance)
+int findKNearestCities(SpatialIndex* idx, double lat, double lon, int k,
+                       int outIds[], double outKm[]);
+int findCitiesWithinRadius(SpatialIndex* idx, double lat, double lon,
+                           double radiusKm, int outIds[], double outKm[],
+                           int maxOut);
+int snapToNearestCity(SpatialIndex* idx, double lat, double lon, double* km);
+
+// Geometry
+double greatCircleDistance(double lat1, double lon1, double lat2, double lon2);
+
+#endif // SPATIAL_H
@@ -0,0 +1,263 @@
+// --- FILE: statusexport.c ---
+#include "statusexport.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void initStatusExporter(StatusExporter* ex, const char* snapshotPath,
+                        const char* deltaPath) {
+    strncpy(ex->snapshotPath, snapshotPath, STATUS_PATH_LEN - 1);
+    ex->snapshotPath[STATUS_PATH_LEN - 1] = '\0';
+    strncpy(ex->deltaPath, deltaPath, STATUS_PATH_LEN - 1);
+    ex->deltaPath[STATUS_PATH_LEN - 1] = '\0';
+    ex->sequence = 0;
+    ex->active = 0;
+    ex->stats = (StatusExportStats){0};
+}
+
+// --- Record Layout ---
+static size_t statusColumnBytes(int rows) {
+    return (size_t)rows * 5 * sizeof(int32_t) + (((size_t)rows + 3) & ~(size_t)3);
+}
+
+// Column start offsets within a record body
+typedef struct StatusColumns {
+    int32_t* slot;
+    int32_t* cityId;
+    int32_t* allocated;
+    int32_t* donorId;
+    int32_t* distance;
+    uint8_t* status;
+} StatusColumns;
+
+static StatusColumns statusColumns(char* body, int rows) {
+    StatusColumns c;
+    c.slot = (int32_t*)body;
+    c.cityId = c.slot + rows;
+    c.allocated = c.cityId + rows;
+    c.donorId = c.allocated + rows;
+    c.distance = c.donorId + rows;
+    c.status = (uint8_t*)(c.distance + rows);
+    return c;
+}
+
+// Build one record from the given slots; caller frees *out
+static size_t buildRecord(const HashMap* map, StatusRecordKind kind,
+                          uint32_t sequence, uint32_t baseSequence,
+                          const int slots[], int rows, char** out) {
+    size_t bytes = sizeof(StatusRecordHeader) + statusColumnBytes(rows);
+    char* buf = (char*)calloc(1, bytes);
+    if (!buf) {
+        fprintf(stderr, "Status export memory failed\n");
+        exit(1);
+    }
+
+    StatusRecordHeader h;
+    memcpy(h.magic, STATUS_MAGIC, 4);
+    h.format = STATUS_FORMAT_VERSION;
+    h.kind = (uint16_t)kind;
+    h.sequence = sequence;
+    h.baseSequence = baseSequence;
+    h.rows = (uint32_t)rows;
+    h.totalRows = (uint32_t)map->numEntries;
+    h.bytes = (uint32_t)bytes;
+    h.reserved = 0;
+    memcpy(buf, &h, sizeof(h));
+
+    StatusColumns c = statusColumns(buf + sizeof(h), rows);
+    for (int i = 0; i < rows; i++) {
+        int s = slots ? slots[i] : i;
+        const HashEntry* e = map->entries[s];
+        c.slot[i] = s;
+        c.cityId[i] = e->cityId;
+        c.allocated[i] = e->resourcesAllocated;
+        c.donorId[i] = e->donorId;
+        c.distance[i] = e->distance;
+        c.status[i] = (uint8_t)e->status;
+    }
+    *out = buf;
+    return bytes;
+}
+
+// --- Writer ---
+// Full table, written to a temporary file and renamed into place so a
+// reader never sees half a snapshot. Starts a fresh delta file.
+// Returns rows written, or -1 on an I/O error.
+int exportStatusSnapshot(StatusExporter* ex, HashMap* map) {
+    double start = nowMs();
+    char* record;
+    uint32_t sequence = ex->sequence + 1;
+    size_t bytes = buildRecord(map, STATUS_RECORD_FULL, sequence, 0,
+                               NULL, map->numEntries, &record);
+
+    char tmpPath[STATUS_PATH_LEN + 4];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", ex->snapshotPath);
+    FILE* fp = fopen(tmpPath, "wb");
+    int ok = fp && fwrite(record, 1, bytes, fp) == bytes;
+    if (fp && fclose(fp) != 0) ok = 0;
+    free(record);
+    if (ok && rename(tmpPath, ex->snapshotPath) != 0) {
+        // Windows will not rename over an existing file
+        remove(ex->snapshotPath);
+        ok = rename(tmpPath, ex->snapshotPath) == 0;
+    }
+    if (!ok) {
+        remove(tmpPath);
+        return -1;
+    }
+
+    // Old deltas chain to the previous sequence, so readers ignore them
+    // even before the truncation lands
+    fp = fopen(ex->deltaPath, "wb");
+    if (fp) fclose(fp);
+
+    clearDirtySlots(map);
+    ex->sequence = sequence;
+    ex->active = 1;
+    ex->stats.snapshots++;
+    ex->stats.rowsWritten += map->numEntries;
+    ex->stats.bytesWritten += bytes;
+    ex->stats.lastMs = nowMs() - start;
+    return map->numEntries;
+}
+
+// Append only the rows changed since the last record. Returns rows
+// written (0 if nothing changed or no snapshot yet), -1 on an I/O error;
+// on error the rows stay dirty and go out with the next delta.
+int exportStatusDelta(StatusExporter* ex, HashMap* map) {
+    if (!ex->active || map->numDirty == 0) return 0;
+
+    double start = nowMs();
+    char* record;
+    int rows = map->numDirty;
+    size_t bytes = buildRecord(map, STATUS_RECORD_DELTA, ex->sequence + 1,
+                               ex->sequence, map->dirtySlots, rows, &record);
+
+    FILE* fp = fopen(ex->deltaPath, "ab");
+    int ok = fp && fwrite(record, 1, bytes, fp) == bytes;
+    if (fp && fclose(fp) != 0) ok = 0;
+    free(record);
+    if (!ok) return -1;
+
+    clearDirtySlots(map);
+    ex->sequence++;
+    ex->stats.deltas++;
+    ex->stats.rowsWritten += rows;
+    ex->stats.bytesWritten += bytes;
+    ex->stats.lastMs = nowMs() - start;
+    return rows;
+}
+
+void printStatusExportStats(const StatusExporter* ex) {
+    printf("Status export  | Sequence: %u | Snapshots: %lu | Deltas: %lu\n",
+           ex->sequence, ex->stats.snapshots, ex->stats.deltas);
+    printf("%-14s | Rows: %lu | Bytes: %lu | Last: %.3f ms\n", "",
+           ex->stats.rowsWritten, ex->stats.bytesWritten, ex->stats.lastMs);
+}
+
+// --- Reader ---
+// Whole file in one buffer (malloc alignment keeps the columns aligned)
+static char* readWholeFile(const char* path, size_t* size) {
+    *size = 0;
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* buf = (char*)malloc(len > 0 ? (size_t)len : 1);
+    if (!buf) {
+        fprintf(stderr, "Status reader memory failed\n");
+        exit(1);
+    }
+    *size = fread(buf, 1, len > 0 ? (size_t)len : 0, fp);
+    fclose(fp);
+    return buf;
+}
+
+// Validate the record at buf[off]; returns its header or 0 if unusable
+static int readHeader(const char* buf, size_t size, size_t off,
+                      StatusRecordHeader* h) {
+    if (off + sizeof(*h) > size) return 0;
+    memcpy(h, buf + off, sizeof(*h));
+    if (memcmp(h->magic, STATUS_MAGIC, 4) != 0 || h->format != STATUS_FORMAT_VERSION)
+        return 0;
+    if (h->rows > h->totalRows ||
+        h->bytes != sizeof(*h) + statusColumnBytes(h->rows) ||
+        off + h->bytes > size)
+        return 0;       // Corrupt, or a delta still being appended
+    return 1;
+}
+
+// Apply one record's columns to the table; the columns are read in place
+static int applyRecord(StatusTable* t, char* body, const StatusRecordHeader* h) {
+    int total = (int)h->totalRows;
+    if (total > t->rows) {
+        t->cityId = (int32_t*)realloc(t->cityId, total * sizeof(int32_t));
+        t->allocated = (int32_t*)realloc(t->allocated, total * sizeof(int32_t));
+        t->donorId = (int32_t*)realloc(t->donorId, total * sizeof(int32_t));
+        t->distance = (int32_t*)realloc(t->distance, total * sizeof(int32_t));
+        t->status = (uint8_t*)realloc(t->status, total);
+        if (!t->cityId || !t->allocated || !t->donorId || !t->distance || !t->status) {
+            fprintf(stderr, "Status reader memory failed\n");
+            exit(1);
+        }
+        t->rows = total;
+    }
+
+    StatusColumns c = statusColumns(body, (int)h->rows);
+    for (uint32_t i = 0; i < h->rows; i++) {
+        int32_t s = c.slot[i];
+        if (s < 0 || s >= total) return 0;
+        t->cityId[s] = c.cityId[i];
+        t->allocated[s] = c.allocated[i];
+        t->donorId[s] = c.donorId[i];
+        t->distance[s] = c.distance[i];
+        t->status[s] = c.status[i];
+    }
+    t->sequence = h->sequence;
+    return 1;
+}
+
+// Snapshot plus every delta that chains onto it; NULL if the snapshot is
+// missing or corrupt. A torn or foreign delta ends the replay.
+StatusTable* loadStatusTable(const char* snapshotPath, const char* deltaPath) {
+    size_t size;
+    char* buf = readWholeFile(snapshotPath, &size);
+    StatusRecordHeader h;
+    if (!buf || !readHeader(buf, size, 0, &h) || h.kind != STATUS_RECORD_FULL ||
+        h.rows != h.totalRows) {
+        free(buf);
+        return NULL;
+    }
+
+    StatusTable* t = (StatusTable*)calloc(1, sizeof(StatusTable));
+    if (!t) {
+        fprintf(stderr, "Status reader memory failed\n");
+        exit(1);
+    }
+    int ok = applyRecord(t, buf + sizeof(h), &h);
+    free(buf);
+    if (!ok) {
+        freeStatusTable(t);
+        return NULL;
+    }
+
+    buf = readWholeFile(deltaPath, &size);
+    for (size_t off = 0; buf && readHeader(buf, size, off, &h); off += h.bytes) {
+        if (h.kind != STATUS_RECORD_DELTA || h.baseSequence != t->sequence) break;
+        if (!applyRecord(t, buf + off + sizeof(h), &h)) break;
+    }
+    free(buf);
+    return t;
+}
+
+void freeStatusTable(StatusTable* table) {
+    if (!table) return;
+    free(table->cityId);
+    free(table->allocated);
+    free(table->donorId);
+    free(table->distance);
+    free(table->status);
+    free(table);
+}
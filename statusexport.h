@@ -0,0 +1,82 @@
+// --- FILE: statusexport.h ---
+#ifndef STATUSEXPORT_H
+#define STATUSEXPORT_H
+
+#include "graph.h"
+#include "resources.h"
+#include <stdint.h>
+
+#define STATUS_SNAPSHOT_FILE "status_snapshot.bin"
+#define STATUS_DELTA_FILE "status_delta.bin"
+#define STATUS_MAGIC "DRST"
+#define STATUS_FORMAT_VERSION 1
+#define STATUS_PATH_LEN 256
+
+// Donor column values that are not city ids
+#define STATUS_DONOR_NONE DONOR_NONE
+#define STATUS_DONOR_MULTIPLE DONOR_MULTIPLE
+
+typedef enum {
+    STATUS_RECORD_FULL,
+    STATUS_RECORD_DELTA
+} StatusRecordKind;
+
+// Fixed 32-byte record header (native byte order). A record is the
+// header followed by six columns of `rows` values each:
+//   int32 slot, int32 cityId, int32 allocated, int32 donorId,
+//   int32 distance, uint8 status (padded to a multiple of 4 bytes).
+// The snapshot file holds one full record; the delta file holds delta
+// records appended since that snapshot, each applying on top of the last.
+typedef struct StatusRecordHeader {
+    char magic[4];
+    uint16_t format;
+    uint16_t kind;              // StatusRecordKind
+    uint32_t sequence;
+    uint32_t baseSequence;      // Record this one applies on top of (0 if full)
+    uint32_t rows;              // Rows in this record
+    uint32_t totalRows;         // Table size once applied
+    uint32_t bytes;             // Header plus columns
+    uint32_t reserved;
+} StatusRecordHeader;
+
+// Export metrics
+typedef struct StatusExportStats {
+    unsigned long snapshots;
+    unsigned long deltas;
+    unsigned long rowsWritten;
+    unsigned long bytesWritten;
+    double lastMs;              // Time of the last export
+} StatusExportStats;
+
+// Writer state: deltas are only written once a snapshot exists
+typedef struct StatusExporter {
+    char snapshotPath[STATUS_PATH_LEN];
+    char deltaPath[STATUS_PATH_LEN];
+    uint32_t sequence;          // Last record written
+    int active;
+    StatusExportStats stats;
+} StatusExporter;
+
+// Status table as a reader sees it, one array per column
+typedef struct StatusTable {
+    uint32_t sequence;
+    int rows;
+    int32_t* cityId;
+    int32_t* allocated;
+    int32_t* donorId;
+    int32_t* distance;
+    uint8_t* status;
+} StatusTable;
+
+// Writer
+void initStatusExporter(StatusExporter* ex, const char* snapshotPath,
+                        const char* deltaPath);
+int exportStatusSnapshot(StatusExporter* ex, HashMap* map);
+int exportStatusDelta(StatusExporter* ex, HashMap* map);
+void printStatusExportStats(const StatusExporter* ex);
+
+// Reference reader: snapshot plus every complete delta after it
+StatusTable* loadStatusTable(const char* snapshotPath, const char* deltaPath);
+void freeStatusTable(StatusTable* table);
+
+#endif // STATUSEXPORT_H
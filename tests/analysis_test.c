@@ -0,0 +1,153 @@
+// --- FILE: tests/analysis_test.c ---
+// Vulnerability analysis against Floyd-Warshall brute force on random
+// multigraphs: per-road removal impact, bridges, edge betweenness
+// (shortest-path counts), articulation points and cut-off sizes.
+#include "graph.h"
+#include "analysis.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+
+#define TEST_GRAPHS 300
+#define FAR (LONG_MAX / 4)
+
+static int weight[MAX_CITIES][MAX_CITIES];     // 0 = no road
+static long base[MAX_CITIES][MAX_CITIES];
+static long without[MAX_CITIES][MAX_CITIES];
+static double paths[MAX_CITIES][MAX_CITIES];  // Shortest-path counts
+
+// All-pairs distances with one road (a, b) or one city (skip) removed
+static void allPairs(int n, long d[MAX_CITIES][MAX_CITIES], int a, int b, int skip) {
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            d[i][j] = (i == j && i != skip) ? 0 : FAR;
+            int removed = (i == a && j == b) || (i == b && j == a);
+            if (weight[i][j] && i != skip && j != skip && !removed && i != j)
+                d[i][j] = weight[i][j];
+        }
+    for (int k = 0; k < n; k++)
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                if (d[i][k] + d[k][j] < d[i][j]) d[i][j] = d[i][k] + d[k][j];
+}
+
+// Shortest-path counts from every source, settling cities by distance
+static void countPaths(int n) {
+    for (int s = 0; s < n; s++) {
+        int order[MAX_CITIES];
+        for (int i = 0; i < n; i++) order[i] = i;
+        for (int i = 0; i < n; i++)
+            for (int j = i + 1; j < n; j++)
+                if (base[s][order[j]] < base[s][order[i]]) {
+                    int t = order[i];
+                    order[i] = order[j];
+                    order[j] = t;
+                }
+        for (int i = 0; i < n; i++) paths[s][i] = 0;
+        paths[s][s] = 1;
+        for (int x = 0; x < n; x++) {
+            int v = order[x];
+            if (v == s) continue;
+            for (int u = 0; u < n; u++)
+                if (weight[u][v] && base[s][u] + weight[u][v] == base[s][v])
+                    paths[s][v] += paths[s][u];
+        }
+    }
+}
+
+// Removal impact, bridge flag and betweenness of one road
+static int checkRoad(int n, const RoadStats* r) {
+    int a = r->src, b = r->dest, w = weight[a][b];
+    allPairs(n, without, a, b, -1);
+
+    long increase = 0;
+    int disconnected = 0, worst = 0;
+    double betweenness = 0;
+    for (int s = 0; s < n; s++)
+        for (int t = s + 1; t < n; t++) {
+            if (base[s][t] >= FAR) continue;
+            double through = 0;
+            if (base[s][a] + w + base[b][t] == base[s][t]) through += paths[s][a] * paths[t][b];
+            if (base[s][b] + w + base[a][t] == base[s][t]) through += paths[s][b] * paths[t][a];
+            betweenness += through / paths[s][t];
+
+            if (without[s][t] >= FAR) {
+                disconnected++;
+                continue;
+            }
+            long extra = without[s][t] - base[s][t];
+            increase += extra;
+            if (extra > worst) worst = (int)extra;
+        }
+
+    return increase != r->distanceIncrease || disconnected != r->pairsDisconnected ||
+           worst != r->maxIncrease || (disconnected > 0) != r->isBridge ||
+           fabs(betweenness - r->betweenness) > 1e-6;
+}
+
+// Articulation flag and cut-off size of one city
+static int checkCity(int n, const VulnerabilityReport* rep, int v) {
+    allPairs(n, without, -1, -1, v);
+
+    int inComp[MAX_CITIES], done[MAX_CITIES] = { 0 };
+    int size = 0, largest = 0, pieces = 0;
+    for (int u = 0; u < n; u++) {
+        inComp[u] = (u != v && base[v][u] < FAR);
+        size += inComp[u];
+    }
+    for (int u = 0; u < n; u++) {
+        if (!inComp[u] || done[u]) continue;
+        int piece = 0;
+        pieces++;
+        for (int w = 0; w < n; w++)
+            if (inComp[w] && without[u][w] < FAR) {
+                done[w] = 1;
+                piece++;
+            }
+        if (piece > largest) largest = piece;
+    }
+
+    int articulation = pieces > 1;
+    int cutOff = articulation ? size - largest : 0;
+    return articulation != (int)CITY_MASK_TEST(rep->articulation, v) || cutOff != rep->cutOff[v];
+}
+
+int main(void) {
+    int fails = 0;
+    long checks = 0;
+    srand(7);
+
+    for (int it = 0; it < TEST_GRAPHS; it++) {
+        int n = 2 + rand() % 20;
+        Graph* g = createGraph(n);
+        for (int i = 0; i < n; i++) addCity(g, i, "c", 1, 1, 1, 0, 0);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++) weight[i][j] = 0;
+
+        // Parallel roads only with equal length, so the matrix stays exact
+        int m = rand() % (2 * n);
+        for (int k = 0; k < m; k++) {
+            int a = rand() % n, b = rand() % n;
+            int w = 1 + rand() % 5;
+            if (a == b || (weight[a][b] && weight[a][b] != w)) continue;
+            addEdge(g, a, b, w);
+            weight[a][b] = weight[b][a] = w;
+        }
+
+        VulnerabilityReport* rep = analyzeNetwork(g, 0, 1);
+        allPairs(n, base, -1, -1, -1);
+        countPaths(n);
+
+        for (int r = 0; r < rep->numRoads; r++, checks++)
+            fails += checkRoad(n, &rep->roads[r]);
+        for (int v = 0; v < n; v++, checks++)
+            fails += checkCity(n, rep, v);
+
+        freeVulnerabilityReport(rep);
+        freeGraph(g);
+    }
+
+    printf("analysis: graphs=%d checks=%ld fails=%d\n", TEST_GRAPHS, checks, fails);
+    return fails != 0;
+}
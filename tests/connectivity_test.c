@@ -0,0 +1,109 @@
+// --- FILE: tests/connectivity_test.c ---
+// Connectivity index against BFS ground truth under random edits: cities
+// and roads added (merges), roads closed (splits) and restricted (no
+// change), checking every city pair as the index catches up.
+// Also checks that paths longer than 999999 km stay reachable.
+#include "graph.h"
+#include "connectivity.h"
+#include "dijkstra.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_GRAPHS 2000
+#define EDITS_PER_GRAPH 200
+#define LONG_ROAD_KM 30000
+
+// Cities reachable from a by breadth-first search
+static void reachable(Graph* g, int a, char seen[]) {
+    int queue[MAX_CITIES], head = 0, tail = 0;
+    for (int i = 0; i < g->numCities; i++) seen[i] = 0;
+    queue[tail++] = a;
+    seen[a] = 1;
+    while (head < tail) {
+        int u = queue[head++];
+        for (EdgeNode* e = g->adjList[u]; e; e = e->next)
+            if (!seen[e->destCity]) {
+                seen[e->destCity] = 1;
+                queue[tail++] = e->destCity;
+            }
+    }
+}
+
+// Every pair, component sizes, masks and the component count
+static int checkIndex(Graph* g, long* checks) {
+    int n = g->numCities, fails = 0, comps = 0;
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    char seenComp[MAX_CITIES] = { 0 };
+    char seen[MAX_CITIES];
+
+    for (int a = 0; a < n; a++) {
+        if (!seenComp[idx->component[a]]) {
+            seenComp[idx->component[a]] = 1;
+            comps++;
+        }
+        reachable(g, a, seen);
+        int size = 0;
+        for (int b = 0; b < n; b++, (*checks)++) {
+            size += seen[b];
+            if (seen[b] != citiesConnected(g, a, b)) fails++;
+        }
+        unsigned int mask[CITY_MASK_WORDS];
+        if (size != componentSize(g, a) || componentMask(g, a, mask) != size) fails++;
+    }
+    if (comps != idx->numComponents) fails++;
+    return fails;
+}
+
+// A chain whose end-to-end distance is far above any old sentinel
+static int checkLongChain(void) {
+    Graph* g = createGraph(MAX_CITIES);
+    for (int i = 0; i < MAX_CITIES; i++) addCity(g, i, "c", 1, 1, 1, 0, 0);
+    for (int i = 0; i + 1 < MAX_CITIES; i++) addEdge(g, i, i + 1, LONG_ROAD_KM);
+
+    int expected = (MAX_CITIES - 1) * LONG_ROAD_KM;
+    int fails = getShortestDistance(g, 0, MAX_CITIES - 1) != expected ||
+                !citiesConnected(g, 0, MAX_CITIES - 1);
+    freeGraph(g);
+    return fails;
+}
+
+int main(void) {
+    int fails = 0;
+    long checks = 0;
+    unsigned long splits = 0, unions = 0, rebuilds = 0;
+    srand(3);
+
+    for (int it = 0; it < TEST_GRAPHS; it++) {
+        Graph* g = createGraph(0);
+        int eager = it % 2;     // Sync after every edit: closures replay as splits
+        int n0 = 1 + rand() % 10;
+        for (int i = 0; i < n0; i++) addCity(g, i, "c", 1, 1, 1, 0, 0);
+
+        for (int step = 0; step < EDITS_PER_GRAPH; step++) {
+            int op = rand() % 10, n = g->numCities;
+            int a = rand() % n, b = rand() % n;
+            if (op == 0 && n < MAX_CITIES)
+                addCity(g, n, "c", 1, 1, 1, 0, 0);
+            else if (op < 6 && a != b)
+                addEdge(g, a, b, 1 + rand() % 9);
+            else if (op < 9)
+                closeRoad(g, a, b);
+            else
+                setRoadRestrictions(g, a, b, -1, 1 + rand() % 300, 1 + rand() % 7);
+
+            if (rand() % 3 == 0) fails += checkIndex(g, &checks);
+            else if (eager) getConnectivityIndex(g);
+        }
+
+        ConnectivityStats* s = &getConnectivityIndex(g)->stats;
+        splits += s->splits;
+        unions += s->unions;
+        rebuilds += s->rebuilds;
+        freeGraph(g);
+    }
+    fails += checkLongChain();
+
+    printf("connectivity: graphs=%d checks=%ld fails=%d (splits=%lu unions=%lu rebuilds=%lu)\n",
+           TEST_GRAPHS, checks, fails, splits, unions, rebuilds);
+    return fails != 0;
+}
@@ -0,0 +1,90 @@
+// --- FILE: tests/distcache_test.c ---
+// Distance cache against fresh Dijkstra while the graph is edited: trees
+// replayed across the edit log must match a new search exactly, and
+// every query counts one hit or one miss.
+#include "graph.h"
+#include "dijkstra.h"
+#include "distcache.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_GRAPHS 500
+#define EDITS_PER_GRAPH 300
+
+// Cached tree matches a fresh search: same distances, parents on roads
+// that realise them
+static int checkTree(Graph* g, int src) {
+    int dist[MAX_CITIES], parent[MAX_CITIES];
+    int fresh[MAX_CITIES], freshParent[MAX_CITIES];
+    cachedDijkstra(g, src, dist, parent);
+    dijkstra(g, src, fresh, freshParent);
+
+    int fails = 0;
+    for (int v = 0; v < g->numCities; v++) {
+        if (dist[v] != fresh[v]) {
+            fails++;
+            continue;
+        }
+        if (v == src || dist[v] == INF) {
+            fails += parent[v] != -1;
+            continue;
+        }
+        int onRoad = 0;
+        for (EdgeNode* e = g->adjList[v]; e; e = e->next)
+            if (e->destCity == parent[v] && dist[parent[v]] + e->distance == dist[v]) onRoad = 1;
+        fails += !onRoad;
+    }
+    return fails;
+}
+
+int main(void) {
+    int fails = 0;
+    long checks = 0;
+    unsigned long revalidations = 0, invalidations = 0;
+    srand(5);
+
+    for (int it = 0; it < TEST_GRAPHS; it++) {
+        Graph* g = createGraph(0);
+        int n0 = 2 + rand() % 20;
+        for (int i = 0; i < n0; i++) addCity(g, i, "c", 1, 1, 1, 0, 0);
+
+        for (int step = 0; step < EDITS_PER_GRAPH; step++) {
+            int op = rand() % 10, n = g->numCities;
+            int a = rand() % n, b = rand() % n;
+            if (op == 0 && n < MAX_CITIES)
+                addCity(g, n, "c", 1, 1, 1, 0, 0);
+            else if (op < 5 && a != b) {
+                int range = (rand() % 2) ? 20 : 500;      // Mostly short, some long
+                addEdge(g, a, b, 1 + rand() % range);
+            }
+            else if (op < 8)
+                closeRoad(g, a, b);
+            else
+                setRoadRestrictions(g, a, b, -1, 1 + rand() % 300, 1 + rand() % 7);
+
+            // Few sources, so cached trees live across many edits
+            for (int q = 0; q < 3; q++, checks++)
+                fails += checkTree(g, rand() % (n < 4 ? n : 4));
+        }
+
+        // One hit or one miss per distance query, whichever end is cached
+        DistanceCache* cache = getDistanceCache(g);
+        for (int q = 0; q < 50; q++, checks++) {
+            int n = g->numCities, src = rand() % n, dest = rand() % n;
+            int fresh[MAX_CITIES], freshParent[MAX_CITIES];
+            unsigned long before = cache->stats.hits + cache->stats.misses;
+            int d = getShortestDistance(g, src, dest);
+            dijkstra(g, src, fresh, freshParent);
+            fails += d != fresh[dest];
+            fails += cache->stats.hits + cache->stats.misses != before + 1;
+        }
+
+        revalidations += cache->stats.revalidations;
+        invalidations += cache->stats.invalidations;
+        freeGraph(g);
+    }
+
+    printf("distcache: graphs=%d checks=%ld fails=%d (revalidations=%lu invalidations=%lu)\n",
+           TEST_GRAPHS, checks, fails, revalidations, invalidations);
+    return fails != 0;
+}
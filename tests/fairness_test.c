@@ -0,0 +1,102 @@
+// --- FILE: tests/fairness_test.c ---
+// Fair batch allocation on random networks: shares are capped by need,
+// fully dispatched and paid for from donor stock, max-min fair by weight
+// within each component, and never leave stock idle while a request in
+// that component is still short.
+#include "fairness.h"
+#include "connectivity.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_GRAPHS 300
+
+// Every request keeps its share within need and is sent what it was granted
+static int checkShares(Graph* g, const FairBatch* b, long stockBefore) {
+    int fails = 0;
+    long sent = 0, stockAfter = 0;
+    for (int r = 0; r < b->numRequests; r++) {
+        sent += b->sent[r];
+        fails += b->sent[r] != b->share[r];
+        fails += b->share[r] < 0 || b->share[r] > b->requests[r].resourcesNeeded;
+    }
+    for (int i = 0; i < g->numCities; i++) stockAfter += g->cities.availableResources[i];
+    fails += stockBefore - stockAfter != sent || sent != b->granted;
+    return fails;
+}
+
+// Water-filling: a request left short cannot have a neighbour in its
+// component more than one unit above its level, and its component's
+// donors must be empty
+static int checkLevels(Graph* g, const FairBatch* b) {
+    int fails = 0;
+    ConnectivityIndex* idx = getConnectivityIndex(g);
+    for (int r = 0; r < b->numRequests; r++) {
+        if (b->share[r] >= b->requests[r].resourcesNeeded) continue;
+        int comp = idx->component[b->requests[r].cityId];
+        double level = (b->share[r] + 1) / b->weight[r];
+        for (int q = 0; q < b->numRequests; q++)
+            if (idx->component[b->requests[q].cityId] == comp && b->share[q] > 0 &&
+                (b->share[q] - 1) / b->weight[q] > level + 1e-9)
+                fails++;
+    }
+
+    unsigned int inBatch[CITY_MASK_WORDS] = { 0 };
+    int shortComp[MAX_CITIES] = { 0 };
+    for (int r = 0; r < b->numRequests; r++) {
+        CITY_MASK_SET(inBatch, b->requests[r].cityId);
+        if (b->share[r] < b->requests[r].resourcesNeeded)
+            shortComp[idx->component[b->requests[r].cityId]] = 1;
+    }
+    for (int i = 0; i < g->numCities; i++)
+        if (!CITY_MASK_TEST(inBatch, i) && g->cities.damageLevel[i] <= 6 &&
+            shortComp[idx->component[i]] && g->cities.availableResources[i] > 0)
+            fails++;
+    return fails;
+}
+
+int main(void) {
+    int fails = 0;
+    long checks = 0;
+    double maxSolveMs = 0;
+    srand(11);
+
+    for (int it = 0; it < TEST_GRAPHS; it++) {
+        Graph* g = createGraph(0);
+        int n = 2 + rand() % (MAX_CITIES - 2);
+        for (int i = 0; i < n; i++)
+            addCity(g, i, "c", rand() % 100000, rand() % 11, rand() % 600, 0, 0);
+        for (int k = 0; k < n; k++) {
+            int a = rand() % n, b = rand() % n;
+            if (a != b) addEdge(g, a, b, 1 + rand() % 99);
+        }
+
+        // Every tenth batch is large
+        PriorityQueue* pq = createPriorityQueue();
+        int numRequests = 1 + rand() % (it % 10 == 0 ? MAX_REQUESTS : 30);
+        for (int r = 0; r < numRequests; r++) {
+            CityRequest q = { 0 };
+            q.requestId = -1;
+            q.cityId = rand() % n;
+            q.urgency = 1 + rand() % 10;
+            q.resourcesNeeded = rand() % 400;
+            pushRequest(pq, q);
+        }
+
+        long stockBefore = 0;
+        for (int i = 0; i < n; i++) stockBefore += g->cities.availableResources[i];
+
+        FairBatch* b = allocateFairBatch(g, pq);
+        if (b->solveMs > maxSolveMs) maxSolveMs = b->solveMs;
+        fails += checkShares(g, b, stockBefore);
+        fails += checkLevels(g, b);
+        checks += b->numRequests;
+
+        free(b);
+        free(pq);
+        freeGraph(g);
+    }
+
+    printf("fairness: graphs=%d checks=%ld fails=%d (max solve %.3f ms)\n",
+           TEST_GRAPHS, checks, fails, maxSolveMs);
+    return fails != 0;
+}
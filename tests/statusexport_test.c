@@ -0,0 +1,82 @@
+// --- FILE: tests/statusexport_test.c ---
+// Status export round trip: random inserts and status changes, exported
+// as occasional snapshots and frequent deltas, must replay through the
+// reference reader into exactly the live table. A torn trailing delta
+// must be ignored.
+#include "statusexport.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_STEPS 3000
+#define TEST_CITIES 45
+#define TEST_SNAPSHOT "tests/status_snapshot.tmp"
+#define TEST_DELTA "tests/status_delta.tmp"
+
+// Reader's table against the live map, row by row
+static int checkTable(const StatusExporter* ex, HashMap* map) {
+    StatusTable* t = loadStatusTable(ex->snapshotPath, ex->deltaPath);
+    if (!t) return 1;
+
+    int fails = t->rows != map->numEntries || t->sequence != ex->sequence;
+    for (int s = 0; !fails && s < t->rows; s++) {
+        const HashEntry* e = map->entries[s];
+        fails += t->cityId[s] != e->cityId || t->allocated[s] != e->resourcesAllocated ||
+                 t->donorId[s] != e->donorId || t->distance[s] != e->distance ||
+                 t->status[s] != e->status;
+    }
+    freeStatusTable(t);
+    return fails;
+}
+
+int main(void) {
+    const char* support[] = { "N/A", "Partial", "Multiple", "C3", "C17" };
+    const int donors[] = { DONOR_NONE, DONOR_NONE, DONOR_MULTIPLE, 3, 17 };
+    int fails = 0, loads = 0;
+    char name[16];
+    srand(9);
+
+    HashMap* map = createHashMap();
+    StatusExporter ex;
+    initStatusExporter(&ex, TEST_SNAPSHOT, TEST_DELTA);
+
+    for (int step = 0; step < TEST_STEPS; step++) {
+        int op = rand() % 10, city = rand() % TEST_CITIES;
+        sprintf(name, "C%d", city);
+        if (op < 4) {
+            // A few names without a city id, as for ad-hoc entries
+            int k = rand() % 5;
+            Status st = (Status)(rand() % 4);
+            int allocated = rand() % 500;
+            insertHashEntry(map, city < 40 ? city : -1, name, st, allocated,
+                            donors[k], support[k], rand() % 900);
+        } else if (op < 7) {
+            setStatus(map, name, (Status)(rand() % 4));
+        } else if (op == 7 && rand() % 10 == 0) {
+            exportStatusSnapshot(&ex, map);
+        } else {
+            exportStatusDelta(&ex, map);
+        }
+
+        if (ex.active && map->numDirty == 0 && rand() % 5 == 0) {
+            fails += checkTable(&ex, map);
+            loads++;
+        }
+    }
+
+    // Half a record appended by a writer that died mid-write
+    exportStatusDelta(&ex, map);
+    FILE* fp = fopen(TEST_DELTA, "ab");
+    if (fp) {
+        fwrite(STATUS_MAGIC "\1\0\1\0", 1, 8, fp);
+        fclose(fp);
+    }
+    fails += checkTable(&ex, map);
+    loads++;
+
+    printf("statusexport: steps=%d loads=%d fails=%d (sequence %u, %lu bytes written)\n",
+           TEST_STEPS, loads, fails, ex.sequence, ex.stats.bytesWritten);
+    freeHashMap(map);
+    remove(TEST_SNAPSHOT);
+    remove(TEST_DELTA);
+    return fails != 0;
+}
@@ -0,0 +1,182 @@
+// --- FILE: timeroute.c ---
+#include "timeroute.h"
+#include "dijkstra.h"
+#include "distcache.h"
+#include <stdio.h>
+#include <math.h>
+
+// Register a piecewise-linear profile (repeats daily).
+// Rejects profiles where leaving later could arrive earlier (slope < -1),
+// since that breaks the FIFO property the label-setting search relies on.
+int addTravelProfile(Graph* g, const int minuteOfDay[], const int travelMinutes[],
+                     int count) {
+    if (count < 1 || g->numProfiles >= MAX_PROFILES ||
+        g->numProfilePoints + count > MAX_PROFILE_POINTS) {
+        fprintf(stderr, "Profile storage full\n");
+        return -1;
+    }
+
+    for (int k = 0; k < count; k++) {
+        if (minuteOfDay[k] < 0 || minuteOfDay[k] >= MINUTES_PER_DAY ||
+            travelMinutes[k] < 0 || travelMinutes[k] > 32767 ||
+            (k > 0 && minuteOfDay[k] <= minuteOfDay[k - 1])) {
+            fprintf(stderr, "Invalid profile point\n");
+            return -1;
+        }
+        int next = (k + 1) % count;
+        int span = minuteOfDay[next] - minuteOfDay[k];
+        if (span <= 0) span += MINUTES_PER_DAY;
+        if (count > 1 && travelMinutes[next] - travelMinutes[k] < -span) {
+            fprintf(stderr, "Profile violates FIFO\n");
+            return -1;
+        }
+    }
+
+    TravelProfile* p = &g->profiles[g->numProfiles];
+    p->first = (short)g->numProfilePoints;
+    p->count = (short)count;
+    for (int k = 0; k < count; k++) {
+        g->profilePoints[g->numProfilePoints].minuteOfDay = (short)minuteOfDay[k];
+        g->profilePoints[g->numProfilePoints].travelMinutes = (short)travelMinutes[k];
+        g->numProfilePoints++;
+    }
+    return g->numProfiles++;
+}
+
+// Travel minutes when entering the edge at minuteOfDay
+int edgeTravelTime(const Graph* g, const EdgeNode* e, int minuteOfDay) {
+    if (e->profile < 0)
+        return (e->distance * 60 + FREE_FLOW_SPEED_KMPH - 1) / FREE_FLOW_SPEED_KMPH;
+
+    const TravelProfile* p = &g->profiles[e->profile];
+    const ProfilePoint* pts = &g->profilePoints[p->first];
+    if (p->count == 1) return pts[0].travelMinutes;
+
+    int t = minuteOfDay % MINUTES_PER_DAY;
+    if (t < 0) t += MINUTES_PER_DAY;
+
+    // Last breakpoint at or before t (binary search); wrap before the first
+    int lo = 0, hi = p->count - 1, k = p->count - 1;
+    if (t >= pts[0].minuteOfDay) {
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            if (pts[mid].minuteOfDay <= t) { k = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+    } else {
+        t += MINUTES_PER_DAY;
+    }
+
+    int next = (k + 1) % p->count;
+    int m1 = pts[k].minuteOfDay;
+    int m2 = pts[next].minuteOfDay;
+    if (m2 <= m1) m2 += MINUTES_PER_DAY;
+    double frac = (double)(t - m1) / (m2 - m1);
+    return (int)floor(pts[k].travelMinutes +
+                      frac * (pts[next].travelMinutes - pts[k].travelMinutes));
+}
+
+// Vehicle class and load check
+int edgeAllows(const EdgeNode* e, VehicleClass vehicle, int load) {
+    return (e->vehicleMask & VEHICLE_BIT(vehicle)) &&
+           (e->maxLoad == 0 || load <= e->maxLoad);
+}
+
+// Time-dependent Dijkstra (label-setting, valid under FIFO profiles)
+void dijkstraTimeDependent(Graph* g, int source, int departMinute,
+                           VehicleClass vehicle, int load,
+                           int arrival[], int parent[]) {
+    int V = g->numCities;
+    MinHeap* heap = createMinHeap(V);
+
+    for (int v = 0; v < V; v++) {
+        arrival[v] = INF;
+        parent[v] = -1;
+        heap->array[v] = &heap->nodes[v];
+        heap->array[v]->vertex = v;
+        heap->array[v]->distance = INF;
+        heap->pos[v] = v;
+    }
+    heap->size = V;
+    arrival[source] = 0;
+    decreaseKey(heap, source, 0);
+
+    while (!isEmpty(heap)) {
+        MinHeapNode* minNode = extractMin(heap);
+        int u = minNode->vertex;
+        if (arrival[u] == INF) break;
+
+        for (EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            if (!edgeAllows(e, vehicle, load)) continue;
+            int v = e->destCity;
+            int travel = edgeTravelTime(g, e, departMinute + arrival[u]);
+            if (travel < arrival[v] - arrival[u]) {
+                arrival[v] = arrival[u] + travel;
+                parent[v] = u;
+                decreaseKey(heap, v, arrival[v]);
+            }
+        }
+    }
+
+    freeMinHeap(heap);
+}
+
+// Some road from v to parent[v] that realises the tree distance and is open
+static int treeEdgeAllows(const Graph* g, const int dist[], const int parent[],
+                          int v, VehicleClass vehicle, int load) {
+    int p = parent[v];
+    for (const EdgeNode* e = g->adjList[v]; e; e = e->next)
+        if (e->destCity == p && e->distance == dist[v] - dist[p] &&
+            edgeAllows(e, vehicle, load))
+            return 1;
+    return 0;
+}
+
+int pathAllows(const Graph* g, const int dist[], const int parent[], int v,
+               VehicleClass vehicle, int load) {
+    for (; parent[v] != -1; v = parent[v])
+        if (!treeEdgeAllows(g, dist, parent, v, vehicle, load)) return 0;
+    return 1;
+}
+
+// Static Dijkstra restricted to open roads. A shortest-path tree whose
+// roads are all open is also shortest under the restriction, so the
+// search only runs when the cached tree uses a closed road.
+void dijkstraForVehicle(Graph* g, int source, VehicleClass vehicle, int load,
+                        int dist[], int parent[]) {
+    int V = g->numCities;
+    cachedDijkstra(g, source, dist, parent);
+    int open = 1;
+    for (int v = 0; v < V && open; v++)
+        if (parent[v] != -1 && !treeEdgeAllows(g, dist, parent, v, vehicle, load))
+            open = 0;
+    if (open) return;
+
+    MinHeap* heap = createMinHeap(V);
+    for (int v = 0; v < V; v++) {
+        dist[v] = INF;
+        parent[v] = -1;
+        heap->array[v] = &heap->nodes[v];
+        heap->array[v]->vertex = v;
+        heap->array[v]->distance = INF;
+        heap->pos[v] = v;
+    }
+    heap->size = V;
+    dist[source] = 0;
+    decreaseKey(heap, source, 0);
+
+    while (!isEmpty(heap)) {
+        int u = extractMin(heap)->vertex;
+        if (dist[u] == INF) break;
+        for (const EdgeNode* e = g->adjList[u]; e; e = e->next) {
+            if (!edgeAllows(e, vehicle, load)) continue;
+            int v = e->destCity;
+            if (e->distance < dist[v] - dist[u]) {
+                dist[v] = dist[u] + e->distance;
+                parent[v] = u;
+                decreaseKey(heap, v, dist[v]);
+            }
+        }
+    }
+    freeMinHeap(heap);
+}
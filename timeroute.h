@@ -0,0 +1,30 @@
+// --- FILE: timeroute.h ---
+#ifndef TIMEROUTE_H
+#define TIMEROUTE_H
+
+#include "graph.h"
+
+#define MINUTES_PER_DAY 1440
+#define FREE_FLOW_SPEED_KMPH 40
+
+// Travel-time profiles
+int addTravelProfile(Graph* g, const int minuteOfDay[], const int travelMinutes[],
+                     int count);
+int edgeTravelTime(const Graph* g, const EdgeNode* e, int minuteOfDay);
+int edgeAllows(const EdgeNode* e, VehicleClass vehicle, int load);
+
+// Earliest-arrival search. arrival[] holds minutes after departure
+// (INF if unreachable for this vehicle/load); parent[] as in dijkstra.
+void dijkstraTimeDependent(Graph* g, int source, int departMinute,
+                           VehicleClass vehicle, int load,
+                           int arrival[], int parent[]);
+
+// Road distances over the roads open to this vehicle and load (INF if
+// unreachable). Reuses the cached tree when every road it uses is open.
+void dijkstraForVehicle(Graph* g, int source, VehicleClass vehicle, int load,
+                        int dist[], int parent[]);
+// Does the tree path from v back to its source admit the vehicle and load?
+int pathAllows(const Graph* g, const int dist[], const int parent[], int v,
+               VehicleClass vehicle, int load);
+
+#endif // TIMEROUTE_H
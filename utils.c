@@ -1,9 +1,11 @@
 // --- FILE: utils.c ---
+#define _POSIX_C_SOURCE 199309L     // clock_gettime under -std=c99
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <time.h>
 
 // Clear input buffer
 void clearInputBuffer() {
@@ -70,7 +72,20 @@ void displayMainMenu() {
     printf("5. Allocate Resources (Process Next Request)\n");
     printf("6. Display Allocation Status\n");
     printf("7. View Allocation Logs\n");
-    printf("8. Exit\n");
+    printf("8. Find Nearest Cities to Location\n");
+    printf("9. System Statistics\n");
+    printf("10. Plan Relief Convoys\n");
+    printf("11. Time-Dependent Route Query\n");
+    printf("12. Close Road\n");
+    printf("13. Run Disaster Simulation\n");
+    printf("14. Monte Carlo Scenario Analysis\n");
+    printf("15. Network Vulnerability Analysis\n");
+    printf("16. Connectivity Report\n");
+    printf("17. Region Partition & Routing\n");
+    printf("18. Export Status Snapshot\n");
+    printf("19. Fair Batch Allocation\n");
+    printf("20. Inventory & Shipments\n");
+    printf("21. Exit\n");
     printf("=======================================================================\n");
 }
 
@@ -124,3 +139,10 @@ int stringCompare(const char* str1, const char* str2) {
     }
     return (*str1 == *str2);
 }
+
+// Monotonic wall-clock milliseconds, for timing reports
+double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
@@ -19,4 +19,7 @@ void displayLogFile();
 void trim(char* str);
 int stringCompare(const char* str1, const char* str2);
 
+// Timing
+double nowMs(void);
+
 #endif